@@ -0,0 +1,141 @@
+#include <xtd/compressed_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// compressed_vector on time series next to a plain xtd::vector: appending,
+// scanning and random reads, with the memory each of them holds reported as
+// the `bytes_per_element` counter.
+
+namespace {
+// Nanosecond timestamps of samples taken every millisecond, with up to 50us
+// of scheduling jitter and an occasional missed sample.
+std::vector<uint64_t> timestamps(size_t n) {
+  std::mt19937_64 random{1};
+  std::vector<uint64_t> values(n);
+  uint64_t t = uint64_t{1700000000} * 1000000000;
+  for (auto& v : values) {
+    t += 1000000 * ((random() % 1000) ? 1 : 2) + random() % 50000;
+    v = t;
+  }
+  return values;
+}
+
+// A request counter sampled as above: a few hundred increments per sample,
+// with bursts.
+std::vector<uint64_t> counters(size_t n) {
+  std::mt19937_64 random{2};
+  std::vector<uint64_t> values(n);
+  uint64_t c{0};
+  for (auto& v : values) {
+    c += (random() % 100) ? random() % 300 : random() % 5000;
+    v = c;
+  }
+  return values;
+}
+
+std::vector<uint64_t> series(int64_t kind, size_t n) {
+  return kind ? counters(n) : timestamps(n);
+}
+
+constexpr size_t elements = size_t{1} << 22;
+
+std::vector<size_t> random_indices(size_t size) {
+  std::mt19937_64 random{7};
+  std::vector<size_t> indices(1 << 12);
+  for (auto& i : indices) i = random() % size;
+  return indices;
+}
+}
+
+// range(0) picks the series: 0 for timestamps and 1 for counters.
+static void compressed_vector_push(benchmark::State& state) {
+  auto const values = series(state.range(0), elements);
+  size_t bytes{0};
+  for (auto _ : state) {
+    xtd::compressed_vector<uint64_t> v;
+    for (auto t : values) v.push(t);
+    bytes = v.bytes_allocated();
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.counters["bytes_per_element"] = double(bytes) / elements;
+}
+BENCHMARK(compressed_vector_push)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+static void uncompressed_vector_push(benchmark::State& state) {
+  auto const values = series(state.range(0), elements);
+  size_t bytes{0};
+  for (auto _ : state) {
+    xtd::vector<uint64_t, 10> v;
+    for (auto t : values) v.push(t);
+    bytes = v.stats().bytes_allocated;
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.counters["bytes_per_element"] = double(bytes) / elements;
+}
+BENCHMARK(uncompressed_vector_push)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+static void compressed_vector_scan(benchmark::State& state) {
+  xtd::compressed_vector<uint64_t> v;
+  for (auto t : series(state.range(0), elements)) v.push(t);
+  for (auto _ : state) {
+    uint64_t sum{0};
+    v.for_each_span([&sum](xtd::span<uint64_t const> s) {
+      for (auto t : s) sum += t;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.SetBytesProcessed(state.iterations() * elements * sizeof(uint64_t));
+}
+BENCHMARK(compressed_vector_scan)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+static void uncompressed_vector_scan(benchmark::State& state) {
+  xtd::vector<uint64_t, 10> v;
+  for (auto t : series(state.range(0), elements)) v.push(t);
+  auto const& cv = v;
+  for (auto _ : state) {
+    uint64_t sum{0};
+    cv.for_each_span([&sum](xtd::span<uint64_t const> s) {
+      for (auto t : s) sum += t;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.SetBytesProcessed(state.iterations() * elements * sizeof(uint64_t));
+}
+BENCHMARK(uncompressed_vector_scan)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Random reads, which decode a whole segment on almost every access.
+static void compressed_vector_random_access(benchmark::State& state) {
+  xtd::compressed_vector<uint64_t> v;
+  for (auto t : series(state.range(0), elements)) v.push(t);
+  auto const indices = random_indices(elements);
+  for (auto _ : state) {
+    uint64_t sum{0};
+    for (auto i : indices)
+      sum += v[i].match([](uint64_t t) { return t; },
+                        []() { return uint64_t{0}; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(compressed_vector_random_access)->Arg(0)->Arg(1);
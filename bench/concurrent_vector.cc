@@ -0,0 +1,40 @@
+#include <xtd/concurrent_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+xtd::concurrent_vector<int64_t, 4>* shared_concurrent;
+
+xtd::vector<int64_t, 4>* shared_locked;
+std::mutex shared_lock;
+}
+
+static void concurrent_vector_push(benchmark::State& state) {
+  if (state.thread_index() == 0)
+    shared_concurrent = new xtd::concurrent_vector<int64_t, 4>;
+
+  int64_t i{0};
+  for (auto _ : state) shared_concurrent->push(i++);
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) delete shared_concurrent;
+}
+BENCHMARK(concurrent_vector_push)->ThreadRange(1, 64)->UseRealTime();
+
+static void locked_vector_push(benchmark::State& state) {
+  if (state.thread_index() == 0) shared_locked = new xtd::vector<int64_t, 4>;
+
+  int64_t i{0};
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> guard{shared_lock};
+    shared_locked->push(i++);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) delete shared_locked;
+}
+BENCHMARK(locked_vector_push)->ThreadRange(1, 64)->UseRealTime();
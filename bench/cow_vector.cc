@@ -0,0 +1,95 @@
+#include <xtd/cow_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Taking a snapshot of a cow_vector next to deep copying an xtd::vector, and
+// what sharing the data blocks costs the writer.
+
+namespace {
+std::vector<size_t> random_indices(size_t size) {
+  std::mt19937_64 random{7};
+  std::vector<size_t> indices(1 << 12);
+  for (auto& i : indices) i = random() % size;
+  return indices;
+}
+}
+
+static void cow_vector_snapshot(benchmark::State& state) {
+  xtd::cow_vector<int64_t, 4> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  for (auto _ : state) benchmark::DoNotOptimize(v.snapshot());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(cow_vector_snapshot)->Range(1 << 16, 1 << 24);
+
+static void xtd_vector_deep_copy(benchmark::State& state) {
+  xtd::vector<int64_t, 4> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  for (auto _ : state) {
+    xtd::vector<int64_t, 4> copy;
+    copy.reserve(v.size());
+    v.for_each_span([&copy](xtd::span<int64_t> s) {
+      copy.append(s.data, s.data + s.size);
+    });
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(xtd_vector_deep_copy)->Range(1 << 16, 1 << 24);
+
+// Appending, with a snapshot taken and dropped every `range(1)` elements, or
+// never when it is 0.
+static void cow_vector_push(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::cow_vector<int64_t, 4> v;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      v.push(i);
+      if (state.range(1) && i % state.range(1) == 0)
+        benchmark::DoNotOptimize(v.snapshot());
+    }
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(cow_vector_push)->Args({1 << 20, 0})->Args({1 << 20, 1 << 10});
+
+static void xtd_vector_push(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<int64_t, 4> v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(xtd_vector_push)->Arg(1 << 20);
+
+// Random updates, with a snapshot taken before every batch of 4096 when
+// range(1) is set, so that the first update to each block copies it.
+static void cow_vector_update(benchmark::State& state) {
+  xtd::cow_vector<int64_t, 4> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state) {
+    auto const snapshot = state.range(1) ? v.snapshot()
+                                         : decltype(v.snapshot()){};
+    for (auto i : indices) v[i].match([](int64_t& e) { ++e; }, []() {});
+    benchmark::DoNotOptimize(snapshot);
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(cow_vector_update)->Args({1 << 20, 0})->Args({1 << 20, 1});
+
+static void xtd_vector_update(benchmark::State& state) {
+  xtd::vector<int64_t, 4> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state)
+    for (auto i : indices) v[i].match([](int64_t& e) { ++e; }, []() {});
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(xtd_vector_update)->Arg(1 << 20);
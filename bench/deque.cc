@@ -0,0 +1,161 @@
+#include <xtd/deque.hh>
+#include <xtd/memory_resource.hh>
+
+#include <cstdint>
+#include <deque>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+// Tracks the peak number of bytes held by the containers using it.
+struct peak_bytes {
+  size_t current{0};
+  size_t peak{0};
+
+  void allocate(size_t bytes) {
+    current += bytes;
+    peak = (current > peak) ? current : peak;
+  }
+  void deallocate(size_t bytes) { current -= bytes; }
+};
+
+class counting_resource : public xtd::memory_resource {
+  peak_bytes* m_bytes;
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    m_bytes->allocate(bytes);
+    return xtd::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    m_bytes->deallocate(bytes);
+    xtd::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+ public:
+  explicit counting_resource(peak_bytes& bytes) : m_bytes{&bytes} {}
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+  peak_bytes* bytes;
+
+  explicit counting_allocator(peak_bytes& b) : bytes{&b} {}
+  template <typename U>
+  counting_allocator(counting_allocator<U> const& other)
+      : bytes{other.bytes} {}
+
+  T* allocate(size_t n) {
+    bytes->allocate(n * sizeof(T));
+    return std::allocator<T>{}.allocate(n);
+  }
+  void deallocate(T* p, size_t n) {
+    bytes->deallocate(n * sizeof(T));
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(counting_allocator<U> const& other) const {
+    return bytes == other.bytes;
+  }
+  template <typename U>
+  bool operator!=(counting_allocator<U> const& other) const {
+    return bytes != other.bytes;
+  }
+};
+
+template <typename Deque>
+void pop_front(Deque& d) {
+  benchmark::DoNotOptimize(d.pop_front());
+}
+
+template <typename T>
+void pop_front(std::deque<T>& d) {
+  benchmark::DoNotOptimize(d.front());
+  d.pop_front();
+}
+
+template <typename Deque>
+void pop_back(Deque& d) {
+  benchmark::DoNotOptimize(d.pop_back());
+}
+
+template <typename T>
+void pop_back(std::deque<T>& d) {
+  benchmark::DoNotOptimize(d.back());
+  d.pop_back();
+}
+}
+
+// A FIFO that holds range(0) elements while as many more go through it.
+template <typename Deque>
+static void deque_fifo(benchmark::State& state) {
+  const int64_t size = state.range(0);
+  for (auto _ : state) {
+    Deque d;
+    for (int64_t i = 0; i < size; ++i) d.push_back(i);
+    for (int64_t i = 0; i < size; ++i) {
+      d.push_back(i);
+      pop_front(d);
+    }
+    while (!d.empty()) pop_front(d);
+  }
+  state.SetItemsProcessed(state.iterations() * size * 2);
+}
+BENCHMARK_TEMPLATE(deque_fifo, xtd::deque<int64_t, 4>)->Range(1 << 6, 1 << 20);
+BENCHMARK_TEMPLATE(deque_fifo, std::deque<int64_t>)->Range(1 << 6, 1 << 20);
+
+// A work-stealing style queue: the owner pushes and pops at the back, and
+// one in four tasks is taken from the front.
+template <typename Deque>
+static void deque_work_queue(benchmark::State& state) {
+  const int64_t tasks = state.range(0);
+  for (auto _ : state) {
+    Deque d;
+    std::minstd_rand random{1};
+    for (int64_t i = 0; i < tasks; ++i) {
+      d.push_back(i);
+      d.push_back(i);
+      if (random() % 4)
+        pop_back(d);
+      else
+        pop_front(d);
+    }
+    while (!d.empty()) pop_back(d);
+  }
+  state.SetItemsProcessed(state.iterations() * tasks * 2);
+}
+BENCHMARK_TEMPLATE(deque_work_queue, xtd::deque<int64_t, 4>)
+    ->Range(1 << 6, 1 << 20);
+BENCHMARK_TEMPLATE(deque_work_queue, std::deque<int64_t>)
+    ->Range(1 << 6, 1 << 20);
+
+// The peak memory held by a deque of range(0) elements filled from both
+// ends, in bytes per element.
+static void xtd_deque_memory(benchmark::State& state) {
+  peak_bytes bytes;
+  for (auto _ : state) {
+    counting_resource resource{bytes};
+    xtd::deque<int64_t> d{&resource};
+    for (int64_t i = 0; i < state.range(0); ++i)
+      (i & 1) ? d.push_back(i) : d.push_front(i);
+  }
+  state.counters["bytes_per_element"] =
+      double(bytes.peak) / double(state.range(0));
+}
+BENCHMARK(xtd_deque_memory)->Range(1 << 6, 1 << 20);
+
+static void std_deque_memory(benchmark::State& state) {
+  peak_bytes bytes;
+  for (auto _ : state) {
+    std::deque<int64_t, counting_allocator<int64_t>> d{
+        counting_allocator<int64_t>{bytes}};
+    for (int64_t i = 0; i < state.range(0); ++i)
+      (i & 1) ? d.push_back(i) : d.push_front(i);
+  }
+  state.counters["bytes_per_element"] =
+      double(bytes.peak) / double(state.range(0));
+}
+BENCHMARK(std_deque_memory)->Range(1 << 6, 1 << 20);
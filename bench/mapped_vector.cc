@@ -0,0 +1,65 @@
+#include <xtd/mapped_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+std::string bench_path() {
+  return "/tmp/xtd_mapped_vector_bench_" + std::to_string(getpid());
+}
+
+template <typename Vector>
+Vector open(std::string const& path) {
+  return Vector::open(path.c_str())
+      .match([](Vector v) { return v; },
+             []() -> Vector { throw std::runtime_error("open failed"); });
+}
+}
+
+// Rebuilding a table at startup by pushing every element again.
+static void xtd_vector_rebuild(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<int64_t, 4> v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(xtd_vector_rebuild)->Range(1 << 10, 1 << 22);
+
+// Reopening a table that was persisted by a previous run.
+static void mapped_vector_reopen(benchmark::State& state) {
+  const auto path = bench_path();
+  std::remove(path.c_str());
+  {
+    auto v = open<xtd::mapped_vector<int64_t, 4>>(path);
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  }
+  for (auto _ : state) {
+    auto v = open<xtd::mapped_vector<int64_t, 4>>(path);
+    benchmark::DoNotOptimize(v.size());
+  }
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(mapped_vector_reopen)->Range(1 << 10, 1 << 22);
+
+static void mapped_vector_push(benchmark::State& state) {
+  const auto path = bench_path();
+  for (auto _ : state) {
+    std::remove(path.c_str());
+    auto v = open<xtd::mapped_vector<int64_t, 4>>(path);
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    benchmark::DoNotOptimize(v.size());
+  }
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(mapped_vector_push)->Range(1 << 10, 1 << 22);
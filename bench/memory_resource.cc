@@ -0,0 +1,141 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <xtd/huge_page_resource.hh>
+#include <xtd/memory_resource.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+template <uint8_t N>
+static void xtd_vector_push_new_delete(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<int64_t, N> v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_new_delete, 0)->Range(1 << 6, 1 << 20);
+BENCHMARK_TEMPLATE(xtd_vector_push_new_delete, 4)->Range(1 << 6, 1 << 20);
+
+template <uint8_t N>
+static void xtd_vector_push_monotonic(benchmark::State& state) {
+  xtd::monotonic_buffer_resource arena;
+  for (auto _ : state) {
+    {
+      xtd::vector<int64_t, N> v{&arena};
+      for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+      benchmark::DoNotOptimize(v);
+    }
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_monotonic, 0)->Range(1 << 6, 1 << 20);
+BENCHMARK_TEMPLATE(xtd_vector_push_monotonic, 4)->Range(1 << 6, 1 << 20);
+
+namespace {
+// Counts the data TLB misses of the calling thread, when the kernel lets us.
+class dtlb_misses {
+  int m_fd{-1};
+
+ public:
+  dtlb_misses() {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = static_cast<int>(
+        ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  dtlb_misses(dtlb_misses const&) = delete;
+  dtlb_misses& operator=(dtlb_misses const&) = delete;
+
+  ~dtlb_misses() {
+    if (available()) ::close(m_fd);
+  }
+
+  bool available() const { return m_fd >= 0; }
+
+  void start() {
+    if (available()) ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  void stop() {
+    if (available()) ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+
+  uint64_t count() const {
+    uint64_t value{0};
+    if (available() && ::read(m_fd, &value, sizeof(value)) != sizeof(value))
+      value = 0;
+    return value;
+  }
+};
+
+// Sums elements at random positions of a vector much larger than the TLB
+// reach with 4 KiB pages. The data TLB misses per access are reported as a
+// counter where perf events are available.
+template <uint8_t N>
+void random_access(benchmark::State& state, xtd::memory_resource* resource) {
+  xtd::vector<int64_t, N> v{resource};
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+
+  std::mt19937_64 random{7};
+  std::vector<size_t> indices(1 << 16);
+  for (auto& i : indices) i = random() % v.size();
+
+  dtlb_misses misses;
+  misses.start();
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto i : indices)
+      sum += v[i].match([](int64_t x) { return x; },
+                        []() { return int64_t{0}; });
+    benchmark::DoNotOptimize(sum);
+  }
+  misses.stop();
+
+  const auto accesses = state.iterations() * indices.size();
+  state.SetItemsProcessed(accesses);
+  if (misses.available())
+    state.counters["dtlb_misses_per_access"] =
+        static_cast<double>(misses.count()) / accesses;
+}
+}
+
+template <uint8_t N>
+static void xtd_vector_random_access_new_delete(benchmark::State& state) {
+  random_access<N>(state, xtd::new_delete_resource());
+}
+BENCHMARK_TEMPLATE(xtd_vector_random_access_new_delete, 4)
+    ->Range(1 << 20, 1 << 26);
+
+// The data blocks are cut out of 2 MiB chunks, whose total size is reported
+// as the `huge_page_bytes` counter so that a run that never used them shows.
+template <uint8_t N>
+static void xtd_vector_random_access_huge_pages(benchmark::State& state) {
+  xtd::huge_page_resource resource;
+  random_access<N>(state, &resource);
+  if (!resource.mapped_bytes())
+    state.SkipWithError("no data block was served from huge pages");
+  state.counters["huge_page_bytes"] =
+      static_cast<double>(resource.mapped_bytes());
+}
+BENCHMARK_TEMPLATE(xtd_vector_random_access_huge_pages, 4)
+    ->Range(1 << 20, 1 << 26);
@@ -0,0 +1,157 @@
+#include <xtd/optional.hh>
+
+#include <cstdint>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <optional>
+#define XTD_BENCH_STD_OPTIONAL 1
+#else
+#define XTD_BENCH_STD_OPTIONAL 0
+#endif
+
+#include <benchmark/benchmark.h>
+
+// xtd::optional next to std::optional, for a scalar and for a type that owns
+// heap memory. std::optional is only measured when this file is compiled as
+// C++17.
+
+namespace {
+template <typename T>
+T make(int64_t i);
+
+template <>
+int64_t make<int64_t>(int64_t i) {
+  return i;
+}
+
+template <>
+std::string make<std::string>(int64_t i) {
+  return std::string(32, char('a' + i % 26));
+}
+}
+
+template <typename T>
+static void xtd_optional_construct(benchmark::State& state) {
+  const T value = make<T>(1);
+  for (auto _ : state) {
+    xtd::optional<T> o{value};
+    benchmark::DoNotOptimize(o);
+  }
+}
+
+template <typename T>
+static void xtd_optional_copy(benchmark::State& state) {
+  const xtd::optional<T> o{make<T>(2)};
+  for (auto _ : state) {
+    xtd::optional<T> copy{o};
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+template <typename T>
+static void xtd_optional_move(benchmark::State& state) {
+  xtd::optional<T> o{make<T>(3)};
+  for (auto _ : state) {
+    xtd::optional<T> moved{std::move(o)};
+    o = std::move(moved);
+    benchmark::DoNotOptimize(o);
+  }
+}
+
+template <typename T>
+static void xtd_optional_map(benchmark::State& state) {
+  xtd::optional<T> o{make<T>(4)};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(o);
+    auto mapped = o.map([](T const& t) { return sizeof(t); });
+    benchmark::DoNotOptimize(mapped);
+  }
+}
+
+template <typename T>
+static void xtd_optional_match(benchmark::State& state) {
+  xtd::optional<T> some{make<T>(5)};
+  xtd::optional<T> none{xtd::none{}};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(some);
+    benchmark::DoNotOptimize(none);
+    benchmark::DoNotOptimize(
+        some.match([](T const&) { return 1; }, []() { return 0; }) +
+        none.match([](T const&) { return 1; }, []() { return 0; }));
+  }
+}
+
+BENCHMARK_TEMPLATE(xtd_optional_construct, int64_t);
+BENCHMARK_TEMPLATE(xtd_optional_construct, std::string);
+BENCHMARK_TEMPLATE(xtd_optional_copy, int64_t);
+BENCHMARK_TEMPLATE(xtd_optional_copy, std::string);
+BENCHMARK_TEMPLATE(xtd_optional_move, int64_t);
+BENCHMARK_TEMPLATE(xtd_optional_move, std::string);
+BENCHMARK_TEMPLATE(xtd_optional_map, int64_t);
+BENCHMARK_TEMPLATE(xtd_optional_map, std::string);
+BENCHMARK_TEMPLATE(xtd_optional_match, int64_t);
+BENCHMARK_TEMPLATE(xtd_optional_match, std::string);
+
+#if XTD_BENCH_STD_OPTIONAL
+template <typename T>
+static void std_optional_construct(benchmark::State& state) {
+  const T value = make<T>(1);
+  for (auto _ : state) {
+    std::optional<T> o{value};
+    benchmark::DoNotOptimize(o);
+  }
+}
+
+template <typename T>
+static void std_optional_copy(benchmark::State& state) {
+  const std::optional<T> o{make<T>(2)};
+  for (auto _ : state) {
+    std::optional<T> copy{o};
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+template <typename T>
+static void std_optional_move(benchmark::State& state) {
+  std::optional<T> o{make<T>(3)};
+  for (auto _ : state) {
+    std::optional<T> moved{std::move(o)};
+    o = std::move(moved);
+    benchmark::DoNotOptimize(o);
+  }
+}
+
+// The closest std::optional has to map before C++23.
+template <typename T>
+static void std_optional_map(benchmark::State& state) {
+  std::optional<T> o{make<T>(4)};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(o);
+    auto mapped = o ? std::optional<size_t>{sizeof(*o)} : std::nullopt;
+    benchmark::DoNotOptimize(mapped);
+  }
+}
+
+template <typename T>
+static void std_optional_match(benchmark::State& state) {
+  std::optional<T> some{make<T>(5)};
+  std::optional<T> none;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(some);
+    benchmark::DoNotOptimize(none);
+    benchmark::DoNotOptimize((some ? 1 : 0) + (none ? 1 : 0));
+  }
+}
+
+BENCHMARK_TEMPLATE(std_optional_construct, int64_t);
+BENCHMARK_TEMPLATE(std_optional_construct, std::string);
+BENCHMARK_TEMPLATE(std_optional_copy, int64_t);
+BENCHMARK_TEMPLATE(std_optional_copy, std::string);
+BENCHMARK_TEMPLATE(std_optional_move, int64_t);
+BENCHMARK_TEMPLATE(std_optional_move, std::string);
+BENCHMARK_TEMPLATE(std_optional_map, int64_t);
+BENCHMARK_TEMPLATE(std_optional_map, std::string);
+BENCHMARK_TEMPLATE(std_optional_match, int64_t);
+BENCHMARK_TEMPLATE(std_optional_match, std::string);
+#endif
@@ -0,0 +1,76 @@
+#include <xtd/parallel_algorithms.hh>
+#include <xtd/vector.hh>
+
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+constexpr int64_t elements{1 << 24};
+
+xtd::vector<double, 4> const& data() {
+  static auto const v = []() {
+    xtd::vector<double, 4> v;
+    for (int64_t i = 0; i < elements; ++i) v.push(double(i % 1000));
+    return v;
+  }();
+  return v;
+}
+}
+
+// Strong scaling: the problem size is fixed and the thread count varies.
+
+static void parallel_for_each(benchmark::State& state) {
+  xtd::vector<double, 4> v;
+  v.append(data().begin(), data().end());
+  for (auto _ : state)
+    xtd::parallel_for_each(v, [](double& d) { d = std::sqrt(d); },
+                           state.range(0));
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(parallel_for_each)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+static void parallel_transform(benchmark::State& state) {
+  auto const& v = data();
+  xtd::vector<double, 4> out;
+  out.append_n(v.size(), 0);
+  for (auto _ : state)
+    xtd::parallel_transform(v, out, [](double d) { return d * 0.5 + 1; },
+                            state.range(0));
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(parallel_transform)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+static void parallel_reduce(benchmark::State& state) {
+  auto const& v = data();
+  for (auto _ : state) {
+    auto sum = xtd::parallel_reduce(
+        v, 0.0, [](double a, double b) { return a + b; }, state.range(0));
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(parallel_reduce)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+static void parallel_count_if(benchmark::State& state) {
+  auto const& v = data();
+  for (auto _ : state) {
+    auto count = xtd::parallel_count_if(
+        v, [](double d) { return d > 500; }, state.range(0));
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(parallel_count_if)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+static void sequential_accumulate(benchmark::State& state) {
+  auto const& v = data();
+  for (auto _ : state) {
+    auto sum = std::accumulate(v.begin(), v.end(), 0.0);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(sequential_accumulate)->UseRealTime();
@@ -0,0 +1,98 @@
+#include <xtd/serialization.hh>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+struct record {
+  uint64_t key;
+  uint64_t timestamp;
+  double values[6];
+};
+
+std::string bench_path() {
+  return "/tmp/xtd_serialization_bench_" + std::to_string(getpid());
+}
+
+xtd::vector<record, 4> make_records(size_t bytes) {
+  xtd::vector<record, 4> v;
+  v.emplace_back_n(bytes / sizeof(record), [i = uint64_t{0}]() mutable {
+    ++i;
+    return record{i, i * 1000, {0.5 * i, 1.5, 2.5, 3.5, 4.5, 5.5}};
+  });
+  return v;
+}
+}
+
+// The range is the size of the dataset in MiB, up to 1 GiB.
+static void xtd_write_to(benchmark::State& state) {
+  const auto v = make_records(size_t(state.range(0)) << 20);
+  const auto path = bench_path();
+  for (auto _ : state) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    benchmark::DoNotOptimize(xtd::write_to(fd, v));
+    close(fd);
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * v.size() * sizeof(record));
+}
+BENCHMARK(xtd_write_to)->RangeMultiplier(8)->Range(1, 1 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+static void xtd_write_to_checksum(benchmark::State& state) {
+  const auto v = make_records(size_t(state.range(0)) << 20);
+  const auto path = bench_path();
+  for (auto _ : state) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    benchmark::DoNotOptimize(
+        xtd::write_to(fd, v, xtd::checksum_mode::verify));
+    close(fd);
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * v.size() * sizeof(record));
+}
+BENCHMARK(xtd_write_to_checksum)->RangeMultiplier(8)->Range(1, 1 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+static void ofstream_per_element(benchmark::State& state) {
+  const auto v = make_records(size_t(state.range(0)) << 20);
+  const auto path = bench_path();
+  for (auto _ : state) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    for (auto const& r : v)
+      out.write(reinterpret_cast<char const*>(&r), sizeof(r));
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * v.size() * sizeof(record));
+}
+BENCHMARK(ofstream_per_element)->RangeMultiplier(8)->Range(1, 1 << 10)
+    ->Unit(benchmark::kMillisecond);
+
+static void xtd_read_from(benchmark::State& state) {
+  const auto path = bench_path();
+  size_t size{0};
+  {
+    const auto v = make_records(size_t(state.range(0)) << 20);
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    xtd::write_to(fd, v);
+    close(fd);
+    size = v.size();
+  }
+  for (auto _ : state) {
+    xtd::vector<record, 4> v;
+    int fd = open(path.c_str(), O_RDONLY);
+    benchmark::DoNotOptimize(xtd::read_from(fd, v));
+    close(fd);
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * size * sizeof(record));
+}
+BENCHMARK(xtd_read_from)->RangeMultiplier(8)->Range(1, 1 << 10)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,98 @@
+#include <xtd/simd_algorithms.hh>
+#include <xtd/vector.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+template <typename T>
+xtd::vector<T, 4> const& data(int64_t n) {
+  static xtd::vector<T, 4> v;
+  while (v.size() < size_t(n)) v.push(T(v.size() % 251));
+  while (v.size() > size_t(n)) v.pop();
+  return v;
+}
+}
+
+template <typename T>
+static void simd_sum(benchmark::State& state) {
+  auto const& v = data<T>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(xtd::simd::sum(v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(simd_sum, int32_t)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(simd_sum, float)->Range(1 << 10, 1 << 22);
+
+template <typename T>
+static void scalar_sum(benchmark::State& state) {
+  auto const& v = data<T>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        std::accumulate(v.begin(), v.end(), xtd::simd::sum_t<T>{}));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(scalar_sum, int32_t)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(scalar_sum, float)->Range(1 << 10, 1 << 22);
+
+static void simd_minmax(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(xtd::simd::minmax(v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(simd_minmax)->Range(1 << 10, 1 << 22);
+
+static void scalar_minmax(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::minmax_element(v.begin(), v.end()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(scalar_minmax)->Range(1 << 10, 1 << 22);
+
+static void simd_find(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(xtd::simd::find(v, -1));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(simd_find)->Range(1 << 10, 1 << 22);
+
+static void scalar_find(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::find(v.begin(), v.end(), -1));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(scalar_find)->Range(1 << 10, 1 << 22);
+
+static void simd_count(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(xtd::simd::count(v, 7));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(simd_count)->Range(1 << 10, 1 << 22);
+
+static void scalar_count(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::count(v.begin(), v.end(), 7));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(scalar_count)->Range(1 << 10, 1 << 22);
+
+static void simd_equal(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(xtd::simd::equal(v, v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(simd_equal)->Range(1 << 10, 1 << 22);
+
+static void scalar_equal(benchmark::State& state) {
+  auto const& v = data<int32_t>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(std::equal(v.begin(), v.end(), v.begin()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(scalar_equal)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,79 @@
+#include <xtd/soa_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+struct row {
+  double f[16];
+};
+
+using d = double;
+using soa_row = xtd::soa_vector<d, d, d, d, d, d, d, d, d, d, d, d, d, d, d, d>;
+
+xtd::vector<row> make_aos(size_t n) {
+  xtd::vector<row> v;
+  for (size_t i = 0; i < n; ++i) {
+    row r;
+    for (int f = 0; f < 16; ++f) r.f[f] = i + f;
+    v.push(r);
+  }
+  return v;
+}
+
+void fill(soa_row& v, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const double x = i;
+    v.push(x, x + 1, x + 2, x + 3, x + 4, x + 5, x + 6, x + 7, x + 8, x + 9,
+           x + 10, x + 11, x + 12, x + 13, x + 14, x + 15);
+  }
+}
+}
+
+// Reads two of the sixteen fields of every row.
+static void aos_vector_two_field_scan(benchmark::State& state) {
+  const auto v = make_aos(state.range(0));
+  for (auto _ : state) {
+    double total{0};
+    v.for_each_span([&total](xtd::span<row const> s) {
+      for (auto const& r : s) total += r.f[3] * r.f[11];
+    });
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(aos_vector_two_field_scan)->Range(1 << 10, 1 << 22);
+
+static void soa_vector_two_field_scan(benchmark::State& state) {
+  soa_row v;
+  fill(v, state.range(0));
+  for (auto _ : state) {
+    double total{0};
+    auto a = v.column<3>().segments().begin();
+    for (auto const& b : v.column<11>().segments()) {
+      for (size_t i = 0; i < b.size; ++i) total += a->data[i] * b.data[i];
+      ++a;
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(soa_vector_two_field_scan)->Range(1 << 10, 1 << 22);
+
+static void aos_vector_push(benchmark::State& state) {
+  for (auto _ : state) benchmark::DoNotOptimize(make_aos(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(aos_vector_push)->Range(1 << 10, 1 << 20);
+
+static void soa_vector_push(benchmark::State& state) {
+  for (auto _ : state) {
+    soa_row v;
+    fill(v, state.range(0));
+    benchmark::DoNotOptimize(v.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(soa_vector_push)->Range(1 << 10, 1 << 20);
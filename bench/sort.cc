@@ -0,0 +1,95 @@
+#include <xtd/sort.hh>
+#include <xtd/vector.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+std::vector<uint64_t> random_keys(size_t n) {
+  std::mt19937_64 random{42};
+  std::vector<uint64_t> keys(n);
+  for (auto& k : keys) k = random();
+  return keys;
+}
+
+xtd::vector<uint64_t, 4> to_xtd(std::vector<uint64_t> const& keys) {
+  xtd::vector<uint64_t, 4> v;
+  v.append(keys.begin(), keys.end());
+  return v;
+}
+}
+
+// The range is the number of 64-bit keys, from about 10^6 to 6.7 * 10^7.
+static void std_sort_std_vector(benchmark::State& state) {
+  const auto keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = keys;
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(std_sort_std_vector)->RangeMultiplier(4)->Range(1 << 20, 1 << 26)
+    ->Unit(benchmark::kMillisecond);
+
+static void std_sort_xtd_iterators(benchmark::State& state) {
+  const auto keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = to_xtd(keys);
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(std_sort_xtd_iterators)->RangeMultiplier(4)->Range(1 << 20, 1 << 26)
+    ->Unit(benchmark::kMillisecond);
+
+static void xtd_sort(benchmark::State& state) {
+  const auto keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = to_xtd(keys);
+    state.ResumeTiming();
+    xtd::sort(v);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(xtd_sort)->RangeMultiplier(4)->Range(1 << 20, 1 << 26)
+    ->Unit(benchmark::kMillisecond);
+
+static void xtd_parallel_sort(benchmark::State& state) {
+  const auto keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = to_xtd(keys);
+    state.ResumeTiming();
+    xtd::parallel_sort(v);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(xtd_parallel_sort)->RangeMultiplier(4)->Range(1 << 20, 1 << 26)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void xtd_radix_sort(benchmark::State& state) {
+  const auto keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = to_xtd(keys);
+    state.ResumeTiming();
+    xtd::radix_sort(v);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(xtd_radix_sort)->RangeMultiplier(4)->Range(1 << 20, 1 << 26)
+    ->Unit(benchmark::kMillisecond);
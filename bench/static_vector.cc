@@ -0,0 +1,80 @@
+#include <xtd/static_vector.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// A per-packet scratch buffer: filling and draining up to range(0) elements,
+// created afresh for every packet, in a static_vector, an xtd::vector and a
+// std::vector with reserve.
+
+static void static_vector_scratch(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::static_vector<int64_t, 256> v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    int64_t sum{0};
+    for (auto i : v) sum += i;
+    benchmark::DoNotOptimize(sum);
+    while (!v.empty()) benchmark::DoNotOptimize(v.pop());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(static_vector_scratch)->Arg(8)->Arg(64)->Arg(256);
+
+template <uint8_t N>
+static void xtd_vector_scratch(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<int64_t, N> v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+    int64_t sum{0};
+    for (auto i : v) sum += i;
+    benchmark::DoNotOptimize(sum);
+    while (!v.empty()) benchmark::DoNotOptimize(v.pop());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_scratch, 3)->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(xtd_vector_scratch, 8)->Arg(8)->Arg(64)->Arg(256);
+
+static void std_vector_scratch(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<int64_t> v;
+    v.reserve(256);
+    for (int64_t i = 0; i < state.range(0); ++i) v.push_back(i);
+    int64_t sum{0};
+    for (auto i : v) sum += i;
+    benchmark::DoNotOptimize(sum);
+    while (!v.empty()) {
+      benchmark::DoNotOptimize(v.back());
+      v.pop_back();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(std_vector_scratch)->Arg(8)->Arg(64)->Arg(256);
+
+// Copying a full buffer, which is a single memcpy for a static_vector of
+// trivially copyable elements.
+static void static_vector_copy(benchmark::State& state) {
+  xtd::static_vector<int64_t, 256> v;
+  while (v.push(int64_t{1})) {
+  }
+  for (auto _ : state) {
+    auto copy = v;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(static_vector_copy);
+
+static void std_vector_copy(benchmark::State& state) {
+  std::vector<int64_t> v(256, 1);
+  for (auto _ : state) {
+    auto copy = v;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(std_vector_copy);
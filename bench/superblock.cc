@@ -0,0 +1,74 @@
+#include <xtd/superblock.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+std::vector<size_t> random_indices(size_t size) {
+  std::mt19937_64 gen{42};
+  std::uniform_int_distribution<size_t> dist{0, size - 1};
+  std::vector<size_t> indices(1 << 16);
+  for (auto& i : indices) i = dist(gen);
+  return indices;
+}
+}
+
+#if defined(__x86_64__)
+// The decoding used before locate became constexpr, kept for comparison.
+static xtd::superblock::location bsr_decode(size_t pos) {
+  pos += 1;
+  uint64_t k;
+  __asm__("\tbsr %1, %0\n" : "=r"(k) : "r"(pos));
+
+  const uint64_t kdiv2 = k >> 1;
+  const uint64_t oneShlKdiv2 = (uint64_t{1} << kdiv2);
+  const uint64_t notKdiv2 = oneShlKdiv2 - 1;
+  const uint64_t mask_b = (notKdiv2 << kdiv2) << (k & 1);
+  const uint64_t mask_seg = (oneShlKdiv2 << (k & 1)) - 1;
+  const uint64_t b = ((pos & mask_b) >> kdiv2) >> (k & 1);
+  const uint64_t seg = pos & mask_seg;
+  return {k, (notKdiv2 << 1) + (k & 1) * oneShlKdiv2 + b, seg, mask_seg + 1};
+}
+
+static void bsr_locate(benchmark::State& state) {
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state)
+    for (auto i : indices) benchmark::DoNotOptimize(bsr_decode(i));
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(bsr_locate)->Range(1 << 10, 1 << 30);
+#endif
+
+static void locate(benchmark::State& state) {
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state)
+    for (auto i : indices)
+      benchmark::DoNotOptimize(xtd::superblock::locate(i));
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK(locate)->Range(1 << 10, 1 << 30);
+
+template <uint8_t N>
+static void xtd_vector_random_access(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+  auto const indices = random_indices(state.range(0));
+
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto i : indices)
+      sum += v[i].match([](int64_t j) { return j; }, []() { return 0l; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+BENCHMARK_TEMPLATE(xtd_vector_random_access, 0)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(xtd_vector_random_access,
+                   xtd::cache_line_segment<int64_t>)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(xtd_vector_random_access, xtd::page_segment<int64_t>)
+    ->Range(1 << 10, 1 << 22);
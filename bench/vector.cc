@@ -0,0 +1,296 @@
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// The core operations of xtd::vector for several segment sizes and element
+// sizes, next to std::vector and std::deque.
+
+namespace {
+template <size_t Bytes>
+struct element {
+  int64_t value[Bytes / sizeof(int64_t)];
+
+  element() = default;
+  element(int64_t i) : value{i} {}
+};
+
+template <typename T>
+int64_t value_of(T const& t) {
+  return t.value[0];
+}
+
+template <typename T, uint8_t N>
+void fill(xtd::vector<T, N>& v, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) v.push(T{i});
+}
+
+template <typename Container>
+void fill(Container& v, int64_t n) {
+  using T = typename Container::value_type;
+  for (int64_t i = 0; i < n; ++i) v.push_back(T{i});
+}
+
+std::vector<size_t> random_indices(size_t size) {
+  std::mt19937_64 random{7};
+  std::vector<size_t> indices(1 << 12);
+  for (auto& i : indices) i = random() % size;
+  return indices;
+}
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_push(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<T, N> v;
+    fill(v, state.range(0));
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void std_push_back(benchmark::State& state) {
+  for (auto _ : state) {
+    Container v;
+    fill(v, state.range(0));
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_pop(benchmark::State& state) {
+  xtd::vector<T, N> v;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fill(v, state.range(0));
+    state.ResumeTiming();
+    while (!v.empty()) benchmark::DoNotOptimize(v.pop());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void std_pop_back(benchmark::State& state) {
+  Container v;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fill(v, state.range(0));
+    state.ResumeTiming();
+    while (!v.empty()) {
+      benchmark::DoNotOptimize(v.back());
+      v.pop_back();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_random_access(benchmark::State& state) {
+  xtd::vector<T, N> v;
+  fill(v, state.range(0));
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto i : indices)
+      sum += v[i].match([](T const& t) { return value_of(t); },
+                        []() { return int64_t{0}; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+template <typename Container>
+static void std_random_access(benchmark::State& state) {
+  Container v;
+  fill(v, state.range(0));
+  auto const indices = random_indices(state.range(0));
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto i : indices) sum += value_of(v[i]);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_iterate(benchmark::State& state) {
+  xtd::vector<T, N> v;
+  fill(v, state.range(0));
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto const& t : v) sum += value_of(t);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void std_iterate(benchmark::State& state) {
+  Container v;
+  fill(v, state.range(0));
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto const& t : v) sum += value_of(t);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_back(benchmark::State& state) {
+  xtd::vector<T, N> v;
+  fill(v, state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(v.back().match(
+        [](T const& t) { return value_of(t); }, []() { return int64_t{0}; }));
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container>
+static void std_back(benchmark::State& state) {
+  Container v;
+  fill(v, state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(value_of(v.back()));
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The cost of 64-bit counters on the push path, next to compact_vector's
+// 32-bit ones.
+template <typename Vector>
+static void vector_push_counters(benchmark::State& state) {
+  for (auto _ : state) {
+    Vector v;
+    for (int64_t i = 0; i < state.range(0); ++i)
+      v.push(typename Vector::value_type(i));
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(vector_push_counters, xtd::vector<int64_t>)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(vector_push_counters, xtd::compact_vector<int64_t>)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(vector_push_counters, xtd::vector<int32_t, 4>)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(vector_push_counters, xtd::compact_vector<int32_t, 4>)
+    ->Range(1 << 10, 1 << 20);
+
+// Many small vectors, e.g. per-entity adjacency lists. The first 2^N
+// elements of an xtd::vector are stored inline and do not allocate.
+template <uint8_t N>
+static void xtd_vector_small(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<xtd::vector<int32_t, N>> lists(1 << 12);
+    for (auto& l : lists)
+      for (int32_t i = 0; i < state.range(0); ++i) l.push(i);
+    benchmark::DoNotOptimize(lists.data());
+  }
+  state.SetItemsProcessed(state.iterations() * (1 << 12));
+}
+BENCHMARK_TEMPLATE(xtd_vector_small, 0)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK_TEMPLATE(xtd_vector_small, 2)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+
+static void std_vector_small(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<std::vector<int32_t>> lists(1 << 12);
+    for (auto& l : lists)
+      for (int32_t i = 0; i < state.range(0); ++i) l.push_back(i);
+    benchmark::DoNotOptimize(lists.data());
+  }
+  state.SetItemsProcessed(state.iterations() * (1 << 12));
+}
+BENCHMARK(std_vector_small)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+
+// Destroying a vector of 10^7 elements, which is a single pass over the
+// blocks for strings and no pass at all for trivially destructible elements.
+template <typename T>
+T make_element(int64_t i);
+
+template <>
+int64_t make_element<int64_t>(int64_t i) {
+  return i;
+}
+
+template <>
+std::string make_element<std::string>(int64_t i) {
+  // longer than the small string buffer, so every element owns heap memory
+  return std::string(24, char('a' + i % 26));
+}
+
+template <typename T, uint8_t N>
+static void xtd_vector_teardown(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = std::make_unique<xtd::vector<T, N>>();
+    int64_t i{0};
+    v->emplace_back_n(state.range(0), [&i]() { return make_element<T>(i++); });
+    state.ResumeTiming();
+    v.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_teardown, std::string, 4)
+    ->Arg(10000000)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(xtd_vector_teardown, int64_t, 4)
+    ->Arg(10000000)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+static void std_vector_teardown(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = std::make_unique<std::vector<T>>();
+    for (int64_t i = 0; i < state.range(0); ++i)
+      v->push_back(make_element<T>(i));
+    state.ResumeTiming();
+    v.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(std_vector_teardown, std::string)
+    ->Arg(10000000)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(std_vector_teardown, int64_t)
+    ->Arg(10000000)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+
+#define XTD_BENCH_VECTOR(op, range)                                   \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<8>, 0)->range;          \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<8>, 2)->range;          \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<8>, 4)->range;          \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<8>, 8)->range;          \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<64>, 0)->range;         \
+  BENCHMARK_TEMPLATE(xtd_vector_##op, element<64>, 4)->range;
+
+#define XTD_BENCH_STD(op, range)                                      \
+  BENCHMARK_TEMPLATE(std_##op, std::vector<element<8>>)->range;       \
+  BENCHMARK_TEMPLATE(std_##op, std::deque<element<8>>)->range;        \
+  BENCHMARK_TEMPLATE(std_##op, std::vector<element<64>>)->range;      \
+  BENCHMARK_TEMPLATE(std_##op, std::deque<element<64>>)->range;
+
+XTD_BENCH_VECTOR(push, Range(1 << 10, 1 << 20))
+XTD_BENCH_STD(push_back, Range(1 << 10, 1 << 20))
+XTD_BENCH_VECTOR(pop, Range(1 << 10, 1 << 20))
+XTD_BENCH_STD(pop_back, Range(1 << 10, 1 << 20))
+XTD_BENCH_VECTOR(random_access, Range(1 << 10, 1 << 22))
+XTD_BENCH_STD(random_access, Range(1 << 10, 1 << 22))
+XTD_BENCH_VECTOR(iterate, Range(1 << 10, 1 << 22))
+XTD_BENCH_STD(iterate, Range(1 << 10, 1 << 22))
+XTD_BENCH_VECTOR(back, Arg(1 << 10))
+XTD_BENCH_STD(back, Arg(1 << 10))
+
+#undef XTD_BENCH_VECTOR
+#undef XTD_BENCH_STD
@@ -0,0 +1,61 @@
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+static std::vector<int64_t> batch(benchmark::State const& state) {
+  std::vector<int64_t> b(state.range(0));
+  std::iota(b.begin(), b.end(), 0);
+  return b;
+}
+
+template <uint8_t N>
+static void xtd_vector_push_batch(benchmark::State& state) {
+  auto const b = batch(state);
+  for (auto _ : state) {
+    xtd::vector<int64_t, N> v;
+    for (auto i : b) v.push(i);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_batch, 0)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(xtd_vector_push_batch, 4)->Range(1 << 10, 1 << 20);
+
+template <uint8_t N>
+static void xtd_vector_append_batch(benchmark::State& state) {
+  auto const b = batch(state);
+  for (auto _ : state) {
+    xtd::vector<int64_t, N> v;
+    v.append(b.data(), b.data() + b.size());
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_append_batch, 0)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(xtd_vector_append_batch, 4)->Range(1 << 10, 1 << 20);
+
+template <uint8_t N>
+static void xtd_vector_append_n(benchmark::State& state) {
+  for (auto _ : state) {
+    xtd::vector<int64_t, N> v;
+    v.append_n(state.range(0), 42);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_append_n, 4)->Range(1 << 10, 1 << 20);
+
+static void std_vector_insert_batch(benchmark::State& state) {
+  auto const b = batch(state);
+  for (auto _ : state) {
+    std::vector<int64_t> v;
+    v.insert(v.end(), b.begin(), b.end());
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(std_vector_insert_batch)->Range(1 << 10, 1 << 20);
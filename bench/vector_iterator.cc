@@ -0,0 +1,52 @@
+#include <xtd/vector.hh>
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+template <uint8_t N>
+static void xtd_vector_range_for(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto&& i : v) sum += i;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_range_for, 0)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(xtd_vector_range_for, 4)->Range(1 << 10, 1 << 24);
+
+// Decodes every index, which is what the iterator used to do on each step.
+template <uint8_t N>
+static void xtd_vector_indexed(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push(i);
+
+  auto const size = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (size_t i = 0; i < size; ++i)
+      sum += v[i].match([](int64_t j) { return j; }, []() { return 0l; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(xtd_vector_indexed, 0)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(xtd_vector_indexed, 4)->Range(1 << 10, 1 << 24);
+
+static void std_vector_range_for(benchmark::State& state) {
+  std::vector<int64_t> v;
+  for (int64_t i = 0; i < state.range(0); ++i) v.push_back(i);
+
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (auto&& i : v) sum += i;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(std_vector_range_for)->Range(1 << 10, 1 << 24);
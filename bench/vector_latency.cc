@@ -0,0 +1,81 @@
+#include <xtd/vector.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// The distribution of the cost of a single push, where a growing directory
+// or a new data block shows up as a spike in the tail.
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+// Pushes state.range(0) elements with `push(i)`, timing each one, and
+// reports percentiles of the per-push latency.
+template <typename Push>
+void push_latency(benchmark::State& state, Push&& push) {
+  std::vector<int64_t> latencies(state.range(0));
+  std::vector<int64_t> all;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      const auto start = clock_type::now();
+      push(i);
+      latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         clock_type::now() - start)
+                         .count();
+    }
+    all.insert(all.end(), latencies.begin(), latencies.end());
+  }
+
+  std::sort(all.begin(), all.end());
+  auto percentile = [&all](double p) {
+    return static_cast<double>(all[static_cast<size_t>(p * (all.size() - 1))]);
+  };
+  state.counters["p50_ns"] = percentile(0.5);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p99.9_ns"] = percentile(0.999);
+  state.counters["p99.99_ns"] = percentile(0.9999);
+  state.counters["max_ns"] = static_cast<double>(all.back());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}
+
+template <uint8_t N>
+static void xtd_vector_push_latency(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  push_latency(state, [&v](int64_t i) { v.push(i); });
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_latency, 0)->Arg(1 << 22);
+BENCHMARK_TEMPLATE(xtd_vector_push_latency, 4)->Arg(1 << 22);
+
+template <uint8_t N>
+static void xtd_vector_push_latency_ahead(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  v.allocate_ahead();
+  push_latency(state, [&v](int64_t i) { v.push(i); });
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_latency_ahead, 0)->Arg(1 << 22);
+BENCHMARK_TEMPLATE(xtd_vector_push_latency_ahead, 4)->Arg(1 << 22);
+
+template <uint8_t N>
+static void xtd_vector_push_latency_reserved(benchmark::State& state) {
+  xtd::vector<int64_t, N> v;
+  v.reserve(state.range(0) * (state.max_iterations + 1));
+  push_latency(state, [&v](int64_t i) { v.push(i); });
+}
+BENCHMARK_TEMPLATE(xtd_vector_push_latency_reserved, 4)
+    ->Arg(1 << 22)
+    ->Iterations(4);
+
+template <typename Container>
+static void std_push_back_latency(benchmark::State& state) {
+  Container v;
+  push_latency(state, [&v](int64_t i) { v.push_back(i); });
+}
+BENCHMARK_TEMPLATE(std_push_back_latency, std::vector<int64_t>)
+    ->Arg(1 << 22);
+BENCHMARK_TEMPLATE(std_push_back_latency, std::deque<int64_t>)->Arg(1 << 22);
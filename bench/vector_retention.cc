@@ -0,0 +1,48 @@
+#include <xtd/vector.hh>
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+xtd::retention policy(int64_t index) {
+  switch (index) {
+    case 0:
+      return xtd::retention::spare_blocks(0);
+    case 1:
+      return xtd::retention::spare_blocks(1);
+    case 2:
+      return xtd::retention::spare_blocks(4);
+    case 3:
+      return xtd::retention::slack_percent(25);
+    default:
+      return xtd::retention::until_shrink();
+  }
+}
+
+char const* policy_name(int64_t index) {
+  static char const* names[] = {"spare_blocks(0)", "spare_blocks(1)",
+                                "spare_blocks(4)", "slack_percent(25)",
+                                "until_shrink"};
+  return names[index];
+}
+}
+
+// A queue-like workload: the size oscillates by range(1) elements above
+// 2^22, where a superblock starts, crossing data block boundaries on the way
+// up and down.
+static void xtd_vector_push_pop_oscillation(benchmark::State& state) {
+  xtd::vector<int64_t, 4> v;
+  v.retain(policy(state.range(0)));
+  for (int64_t i = 0; i < (1 << 22); ++i) v.push(i);
+
+  const int64_t amplitude = state.range(1);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < amplitude; ++i) v.push(i);
+    for (int64_t i = 0; i < amplitude; ++i) benchmark::DoNotOptimize(v.pop());
+  }
+  state.SetLabel(policy_name(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * amplitude * 2);
+}
+BENCHMARK(xtd_vector_push_pop_oscillation)
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {64, 1 << 16}});
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace xtd_test {
+
+// The number of times the global operator new has been called so far.
+size_t allocations();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <xtd/call_tracker.hh>
+
+namespace xtd_test {
+
+// Internal to each test like call_tracker itself, which lives in an anonymous
+// namespace.
+namespace {
+
+// Counts the call_trackers that are alive while it is: the static hooks
+// count every construction, and the copies and moves of prototype() inherit
+// the hooks that count their destruction. The prototype itself is not
+// counted.
+class lifetime_counter {
+  int m_constructed{0};
+  int m_destroyed{0};
+  xtd::call_tracker m_prototype;
+
+ public:
+  lifetime_counter() {
+    auto constructed = [this]() { ++m_constructed; };
+    xtd::call_tracker::onDefaultConstruction(constructed);
+    xtd::call_tracker::onCopyConstruction(constructed);
+    xtd::call_tracker::onMoveConstruction(constructed);
+    auto destroyed = [this]() { ++m_destroyed; };
+    m_prototype.onDestruction(destroyed).onMovedFromDestruction(destroyed);
+  }
+
+  lifetime_counter(lifetime_counter const&) = delete;
+  lifetime_counter& operator=(lifetime_counter const&) = delete;
+
+  ~lifetime_counter() {
+    xtd::call_tracker::onDefaultConstruction([]() {});
+    xtd::call_tracker::onCopyConstruction([]() {});
+    xtd::call_tracker::onMoveConstruction([]() {});
+    m_prototype.onDestruction([]() {}).onMovedFromDestruction([]() {});
+  }
+
+  xtd::call_tracker const& prototype() const { return m_prototype; }
+
+  int constructed() const { return m_constructed; }
+
+  // The number of call_trackers constructed but not destroyed yet.
+  int alive() const { return m_constructed - m_destroyed; }
+};
+}
+}
@@ -0,0 +1,165 @@
+#include <xtd/compressed_vector.hh>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+// Checks `v` against `expected` through operator[], visiting every `stride`th
+// element at a time so that reads jump from segment to segment, and through
+// for_each_span.
+template <typename T, uint8_t N>
+void check(xtd::compressed_vector<T, N> const& v,
+           std::vector<T> const& expected,
+           size_t stride = (size_t{1} << N) + 1) {
+  ASSERT_EQ(expected.size(), v.size());
+  for (size_t start = 0; start < stride; ++start)
+    for (size_t p = start; p < expected.size(); p += stride)
+      ASSERT_EQ(xtd::some(expected[p]), v[p]) << "at " << p;
+  EXPECT_EQ(xtd::optional<T>{xtd::none{}}, v[expected.size()]);
+
+  size_t p{0};
+  v.for_each_span([&](xtd::span<T const> s) {
+    for (auto t : s) ASSERT_EQ(expected[p++], t) << "at " << p - 1;
+  });
+  EXPECT_EQ(expected.size(), p);
+}
+
+template <typename T, uint8_t N, typename Generator>
+void round_trip(size_t n, Generator&& generate) {
+  xtd::compressed_vector<T, N> v;
+  std::vector<T> expected;
+  for (size_t i = 0; i < n; ++i) {
+    expected.push_back(generate(i));
+    v.push(expected.back());
+  }
+  // the last full segment is only frozen by the next push
+  EXPECT_EQ(n ? (n - 1) >> N : 0, v.frozen_segments());
+  check(v, expected);
+}
+}
+
+TEST(compressed_vector, round_trip) {
+  std::mt19937_64 random{42};
+  round_trip<uint64_t, 4>(1000, [&random](size_t) { return random(); });
+  round_trip<int64_t, 6>(1000, [&random](size_t) {
+    return static_cast<int64_t>(random()) >> (random() % 64);
+  });
+  round_trip<int32_t, 3>(1000, [](size_t i) {
+    return (i % 2) ? std::numeric_limits<int32_t>::min()
+                   : std::numeric_limits<int32_t>::max();
+  });
+  round_trip<uint16_t, 5>(1000, [](size_t i) { return uint16_t(60000 - i); });
+  round_trip<uint8_t, 0>(100, [](size_t i) { return uint8_t(i * 7); });
+  round_trip<uint64_t, 8>(3000, [](size_t) { return uint64_t{7}; });
+}
+
+// Spikes in an otherwise regular series are stored as exceptions, including
+// at either end of a segment.
+TEST(compressed_vector, outliers) {
+  round_trip<uint64_t, 6>(1000, [](size_t i) {
+    const bool spike = (i % 37 == 0) || (i % 64 == 1) || (i % 64 == 63);
+    return spike ? (uint64_t{i} << 40) : uint64_t{i * 10};
+  });
+  round_trip<int64_t, 5>(1000, [](size_t i) {
+    return (i % 11 == 0) ? -int64_t(i) * 1000000 : int64_t(i);
+  });
+
+  // each spike costs two exceptions rather than widening its segment
+  xtd::compressed_vector<uint64_t, 10> v;
+  xtd::compressed_vector<uint64_t, 10> regular;
+  std::vector<uint64_t> expected;
+  for (uint64_t i = 0; i < 4096; ++i) {
+    expected.push_back((i % 500 == 0) ? i * 1000000 : i);
+    v.push(expected.back());
+    regular.push(i);
+  }
+  EXPECT_LE(v.bytes_allocated(), regular.bytes_allocated() + 9 * 4 * 8);
+  check(v, expected);
+}
+
+TEST(compressed_vector, pop) {
+  xtd::compressed_vector<int64_t, 3> v;
+  EXPECT_EQ(xtd::optional<int64_t>{xtd::none{}}, v.pop());
+  EXPECT_EQ(xtd::optional<int64_t>{xtd::none{}}, v.back());
+
+  for (int64_t i = 0; i < 100; ++i) v.push(i * i);
+  EXPECT_EQ(12u, v.frozen_segments());
+  EXPECT_EQ(xtd::some(int64_t{99 * 99}), v.back());
+  for (int64_t i = 99; i >= 50; --i) EXPECT_EQ(xtd::some(i * i), v.pop());
+  EXPECT_EQ(6u, v.frozen_segments());
+
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 50; ++i) expected.push_back(i * i);
+  for (int64_t i = 0; i < 50; ++i) {
+    expected.push_back(-i);
+    v.push(-i);
+  }
+  check(v, expected);
+  while (!v.empty()) v.pop();
+  EXPECT_EQ(0u, v.frozen_segments());
+}
+
+// Pushes and pops around a segment boundary only freeze and thaw the segment
+// once it is passed on either side.
+TEST(compressed_vector, boundary) {
+  xtd::compressed_vector<int64_t, 3> v;
+  for (int64_t i = 0; i < 16; ++i) v.push(i);
+  EXPECT_EQ(1u, v.frozen_segments());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(xtd::some(int64_t{15}), v.pop());
+    EXPECT_EQ(1u, v.frozen_segments());
+    v.push(15);
+    EXPECT_EQ(1u, v.frozen_segments());
+  }
+
+  v.push(16);
+  EXPECT_EQ(2u, v.frozen_segments());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(xtd::some(int64_t{16}), v.pop());
+    EXPECT_EQ(2u, v.frozen_segments());
+    v.push(16);
+    EXPECT_EQ(2u, v.frozen_segments());
+  }
+
+  EXPECT_EQ(xtd::some(int64_t{16}), v.pop());
+  EXPECT_EQ(xtd::some(int64_t{15}), v.pop());
+  EXPECT_EQ(1u, v.frozen_segments());
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 15; ++i) expected.push_back(i);
+  check(v, expected);
+}
+
+// Const reads keep no state, so they may run on several threads at a time.
+TEST(compressed_vector, concurrent_reads) {
+  xtd::compressed_vector<uint64_t, 6> v;
+  for (uint64_t i = 0; i < 10000; ++i) v.push((i % 100 == 0) ? i << 40 : i);
+  auto const& cv = v;
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t < 4; ++t)
+    readers.emplace_back([&cv, t] {
+      for (size_t p = t; p < 10000; p += 7)
+        ASSERT_EQ(xtd::some((p % 100 == 0) ? uint64_t{p} << 40 : uint64_t{p}),
+                  cv[p]);
+    });
+  for (auto& reader : readers) reader.join();
+}
+
+// Timestamps a millisecond apart with some jitter take a few bits each.
+TEST(compressed_vector, compresses_timestamps) {
+  std::mt19937_64 random{7};
+  xtd::compressed_vector<uint64_t> v;
+  std::vector<uint64_t> expected;
+  uint64_t t = uint64_t{1700000000} * 1000000000;
+  for (size_t i = 0; i < (size_t{1} << 20); ++i) {
+    t += 1000000 + random() % 1000;
+    expected.push_back(t);
+    v.push(t);
+  }
+  check(v, expected, 1);
+  EXPECT_LT(v.bytes_allocated() * 3, expected.size() * sizeof(uint64_t));
+}
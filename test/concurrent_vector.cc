@@ -0,0 +1,78 @@
+#include <xtd/concurrent_vector.hh>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(concurrent_vector, push) {
+  xtd::concurrent_vector<std::string, 1> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(0u, v.push("Hello"));
+  EXPECT_EQ(1u, v.push(" world!"));
+
+  EXPECT_EQ(2u, v.size());
+  v[0].match([](std::string const& s) { EXPECT_EQ("Hello", s); },
+             []() { ADD_FAILURE() << "The element was pushed."; });
+  v[2].match([](std::string const&) { ADD_FAILURE() << "Out of bounds."; },
+             []() {});
+}
+
+TEST(concurrent_vector, concurrent_push) {
+  static constexpr int threads{8};
+  static constexpr int pushes{20000};
+
+  struct record {
+    int thread;
+    int seq;
+  };
+  xtd::concurrent_vector<record, 2> v;
+  std::atomic<bool> done{false};
+
+  // Readers only ever see fully constructed elements in the published prefix.
+  std::thread reader{[&]() {
+    while (!done) {
+      auto const size = v.size();
+      for (size_t p = 0; p < size; p += 97) {
+        v[p].match(
+            [](record const& r) {
+              EXPECT_LE(0, r.thread);
+              EXPECT_GT(threads, r.thread);
+              EXPECT_LE(0, r.seq);
+              EXPECT_GT(pushes, r.seq);
+            },
+            []() { ADD_FAILURE() << "The element was published."; });
+      }
+    }
+  }};
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < threads; ++t)
+    writers.emplace_back([&v, t]() {
+      for (int i = 0; i < pushes; ++i) v.push(record{t, i});
+    });
+  for (auto& w : writers) w.join();
+  done = true;
+  reader.join();
+
+  ASSERT_EQ(size_t{threads * pushes}, v.size());
+  std::vector<int> next(threads, 0);
+  for (size_t p = 0; p < v.size(); ++p) {
+    v[p].match(
+        [&next](record const& r) { EXPECT_EQ(next[r.thread]++, r.seq); },
+        []() { ADD_FAILURE() << "The element was published."; });
+  }
+  for (auto n : next) EXPECT_EQ(pushes, n);
+}
+
+TEST(concurrent_vector, destroys_elements) {
+  auto counter = std::make_shared<int>(0);
+  {
+    xtd::concurrent_vector<std::shared_ptr<int>> v;
+    for (int i = 0; i < 100; ++i) v.push(counter);
+    EXPECT_EQ(101, counter.use_count());
+  }
+  EXPECT_EQ(1, counter.use_count());
+}
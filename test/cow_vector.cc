@@ -0,0 +1,134 @@
+#include <xtd/call_tracker.hh>
+#include <xtd/cow_vector.hh>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "call_tracker.hh"
+
+namespace {
+template <typename Vector>
+std::string value(Vector const& v, size_t p) {
+  return v[p].match([](std::string const& s) { return s; },
+                    []() { return std::string{"none"}; });
+}
+}
+
+TEST(cow_vector, push_pop) {
+  xtd::cow_vector<std::string, 1> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, v.pop());
+
+  for (int i = 0; i < 100; ++i) v.push(std::to_string(i));
+  EXPECT_EQ(100u, v.size());
+  EXPECT_EQ("42", value(v, 42));
+  EXPECT_EQ("none", value(v, 100));
+  v.back().match([](std::string const& s) { EXPECT_EQ("99", s); },
+                 []() { ADD_FAILURE() << "The vector is not empty."; });
+
+  v[42].match([](std::string& s) { s = "answer"; }, []() {});
+  EXPECT_EQ("answer", value(v, 42));
+
+  for (int i = 99; i >= 0; --i) {
+    auto const expected = (i == 42) ? std::string{"answer"} : std::to_string(i);
+    EXPECT_EQ(xtd::some(expected), v.pop());
+  }
+  EXPECT_TRUE(v.empty());
+}
+
+// A snapshot keeps the elements it was taken with through pushes, updates
+// and pops, and shares the data blocks the vector did not change.
+TEST(cow_vector, snapshot_isolation) {
+  xtd::cow_vector<int64_t, 2> v;
+  for (int64_t i = 0; i < 1000; ++i) v.push(i);
+  auto const before = v.snapshot();
+  EXPECT_EQ(1000u, before.size());
+
+  for (int64_t i = 1000; i < 2000; ++i) v.push(i);
+  v[10].match([](int64_t& i) { i = -1; }, []() {});
+  v[999].match([](int64_t& i) { i = -2; }, []() {});
+  for (int i = 0; i < 500; ++i) v.pop();
+  auto const after = v.snapshot();
+
+  EXPECT_EQ(1000u, before.size());
+  int64_t expected{0};
+  before.for_each_span([&expected](xtd::span<int64_t const> s) {
+    for (auto i : s) EXPECT_EQ(expected++, i);
+  });
+  EXPECT_EQ(1000, expected);
+
+  EXPECT_EQ(1500u, after.size());
+  auto copied = [](int64_t i) { return i; };
+  EXPECT_EQ(xtd::some(int64_t{-1}), after[10].map(copied));
+  EXPECT_EQ(xtd::some(int64_t{-2}), after[999].map(copied));
+  EXPECT_EQ(xtd::some(int64_t{1499}), after.back().map(copied));
+
+  // only the two updated blocks were copied
+  auto const old_segments = before.segments();
+  auto const new_segments = after.segments();
+  size_t shared{0};
+  for (size_t b = 0; b < old_segments.size(); ++b)
+    if (old_segments[b].data == new_segments[b].data) ++shared;
+  EXPECT_EQ(old_segments.size() - 2, shared);
+
+  auto copy = before;
+  copy = after;
+  EXPECT_EQ(1500u, copy.size());
+  auto moved = std::move(copy);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(1500u, moved.size());
+}
+
+// Every element is destroyed once, by whichever of the vector and its
+// snapshots releases its data block last.
+TEST(cow_vector, destroys_elements) {
+  xtd_test::lifetime_counter counter;
+  {
+    xtd::cow_vector<xtd::call_tracker, 2>::snapshot_t kept;
+    {
+      xtd::cow_vector<xtd::call_tracker, 2> v;
+      for (int i = 0; i < 100; ++i) v.push(counter.prototype());
+      auto first = v.snapshot();
+      v.pop();
+      v[0].match([](xtd::call_tracker&) {}, []() {});
+      for (int i = 0; i < 100; ++i) v.push(counter.prototype());
+      kept = v.snapshot();
+      v.pop();
+    }
+    EXPECT_EQ(199u, kept.size());
+    // only the elements the snapshot shares are left
+    EXPECT_EQ(199, counter.alive());
+  }
+  EXPECT_EQ(0, counter.alive());
+}
+
+// A reader sees a consistent snapshot while the writer keeps appending to
+// and updating the vector.
+TEST(cow_vector, concurrent_reader) {
+  xtd::cow_vector<int64_t, 4> v;
+  for (int64_t i = 0; i < 100000; ++i) v.push(i);
+  auto snapshot = v.snapshot();
+
+  std::thread reader{[snapshot]() {
+    for (int round = 0; round < 10; ++round) {
+      int64_t expected{0};
+      snapshot.for_each_span([&expected](xtd::span<int64_t const> s) {
+        for (auto i : s) EXPECT_EQ(expected++, i);
+      });
+      EXPECT_EQ(100000, expected);
+    }
+  }};
+  for (int64_t i = 0; i < 100000; ++i) {
+    v.push(-i);
+    v[i].match([](int64_t& e) { e = -e; }, []() {});
+  }
+  reader.join();
+
+  snapshot = v.snapshot();
+  EXPECT_EQ(200000u, snapshot.size());
+  EXPECT_EQ(xtd::some(int64_t{-99999}),
+            snapshot[99999].map([](int64_t i) { return i; }));
+}
@@ -0,0 +1,136 @@
+#include <xtd/deque.hh>
+#include <xtd/memory_resource.hh>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+// Tracks the bytes held in data blocks and their peak.
+class peak_resource : public xtd::memory_resource {
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    outstanding += bytes;
+    peak = std::max(peak, outstanding);
+    return xtd::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    outstanding -= bytes;
+    xtd::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+ public:
+  size_t outstanding{0};
+  size_t peak{0};
+};
+}
+
+TEST(deque, push_pop) {
+  xtd::deque<std::string, 1> d;
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, d.pop_front());
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, d.pop_back());
+
+  d.push_back("b").push_front("a").push_back("c");
+  EXPECT_EQ(3u, d.size());
+  d.front().match([](std::string const& s) { EXPECT_EQ("a", s); },
+                  []() { ADD_FAILURE() << "The deque is not empty."; });
+  d.back().match([](std::string const& s) { EXPECT_EQ("c", s); },
+                 []() { ADD_FAILURE() << "The deque is not empty."; });
+  d[1].match([](std::string const& s) { EXPECT_EQ("b", s); },
+             []() { ADD_FAILURE() << "The element was pushed."; });
+  d[3].match([](std::string const&) { ADD_FAILURE() << "Out of bounds."; },
+             []() {});
+
+  EXPECT_EQ(xtd::some(std::string{"a"}), d.pop_front());
+  EXPECT_EQ(xtd::some(std::string{"b"}), d.pop_front());
+  EXPECT_EQ(xtd::some(std::string{"c"}), d.pop_front());
+  EXPECT_TRUE(d.empty());
+}
+
+// Popping past one end consumes the other side.
+TEST(deque, fifo) {
+  xtd::deque<int> d;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 1000; ++i) d.push_back(i);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(xtd::some(i), d.pop_front());
+    EXPECT_TRUE(d.empty());
+
+    for (int i = 0; i < 1000; ++i) d.push_front(i);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(xtd::some(i), d.pop_back());
+    EXPECT_TRUE(d.empty());
+  }
+}
+
+// A queue that never empties holds memory for the elements in it, not for
+// all the ones that went through it.
+TEST(deque, steady_state_fifo) {
+  peak_resource resource;
+  {
+    xtd::deque<int> d{&resource};
+    for (int i = 0; i < 16; ++i) d.push_back(i);
+    for (int i = 16; i < 1000000; ++i) {
+      d.push_back(i);
+      ASSERT_EQ(xtd::some(i - 16), d.pop_front());
+    }
+    EXPECT_EQ(16u, d.size());
+    for (int i = 0; i < 16; ++i) d.push_front(-i);
+    for (int i = 0; i < 1000000; ++i) {
+      d.push_front(i);
+      d.pop_back();
+    }
+    EXPECT_EQ(32u, d.size());
+  }
+  EXPECT_EQ(0u, resource.outstanding);
+  EXPECT_LT(resource.peak, 8 * 16 * sizeof(int));
+}
+
+TEST(deque, stable_addresses) {
+  xtd::deque<int, 2> d;
+  d.push_back(0);
+  int* first = nullptr;
+  d.front().match([&first](int& i) { first = &i; }, []() {});
+  for (int i = 1; i < 10000; ++i) d.push_back(i).push_front(-i);
+  d[9999].match([first](int& i) { EXPECT_EQ(first, &i); },
+                []() { ADD_FAILURE() << "The element was pushed."; });
+}
+
+TEST(deque, matches_std_deque) {
+  std::mt19937 random{42};
+  xtd::deque<int, 3> d;
+  std::deque<int> expected;
+  for (int i = 0; i < 100000; ++i) {
+    switch (random() % 4) {
+      case 0:
+        d.push_back(i);
+        expected.push_back(i);
+        break;
+      case 1:
+        d.push_front(i);
+        expected.push_front(i);
+        break;
+      case 2:
+        if (expected.empty()) {
+          EXPECT_TRUE(d.empty());
+        } else {
+          EXPECT_EQ(xtd::some(expected.back()), d.pop_back());
+          expected.pop_back();
+        }
+        break;
+      default:
+        if (expected.empty()) {
+          EXPECT_TRUE(d.empty());
+        } else {
+          EXPECT_EQ(xtd::some(expected.front()), d.pop_front());
+          expected.pop_front();
+        }
+    }
+    ASSERT_EQ(expected.size(), d.size());
+  }
+  for (size_t p = 0; p < expected.size(); ++p)
+    EXPECT_EQ(xtd::some(expected[p]),
+              d[p].map([](int const& i) { return i; }));
+}
@@ -0,0 +1,157 @@
+#include <xtd/mapped_vector.hh>
+#include <xtd/simd_algorithms.hh>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+// A file path that is removed when it goes out of scope.
+struct temporary_path {
+  std::string path;
+
+  temporary_path()
+      : path{"/tmp/xtd_mapped_vector_" + std::to_string(getpid()) + "_" +
+             std::to_string(counter()++)} {}
+
+  ~temporary_path() { std::remove(path.c_str()); }
+
+  static int& counter() {
+    static int c{0};
+    return c;
+  }
+};
+
+template <typename Vector>
+Vector open(std::string const& path) {
+  return Vector::open(path.c_str())
+      .match([](Vector v) { return v; },
+             []() -> Vector { throw std::runtime_error("open failed"); });
+}
+
+template <typename Vector>
+bool opens(std::string const& path) {
+  return Vector::open(path.c_str())
+      .match([](Vector const&) { return true; }, []() { return false; });
+}
+}
+
+TEST(mapped_vector, push_pop) {
+  temporary_path file;
+  auto v = open<xtd::mapped_vector<int64_t, 2>>(file.path);
+  EXPECT_TRUE(v.empty());
+  for (int64_t i = 0; i < 1000; ++i) EXPECT_TRUE(v.push(i));
+  EXPECT_EQ(1000u, v.size());
+
+  v[999].match([](int64_t i) { EXPECT_EQ(999, i); },
+               []() { ADD_FAILURE() << "The element was pushed."; });
+  v[1000].match([](int64_t) { ADD_FAILURE() << "Out of bounds."; }, []() {});
+
+  EXPECT_EQ(xtd::some(int64_t{999}), v.pop());
+  EXPECT_EQ(xtd::some(int64_t{998}), v.pop());
+  EXPECT_TRUE(v.push(-1));
+  v[998].match([](int64_t i) { EXPECT_EQ(-1, i); },
+               []() { ADD_FAILURE() << "The element was pushed."; });
+}
+
+TEST(mapped_vector, reopen) {
+  temporary_path file;
+  {
+    auto v = open<xtd::mapped_vector<uint32_t, 3>>(file.path);
+    for (uint32_t i = 0; i < 100000; ++i) v.push(i * 3);
+  }
+  {
+    auto v = open<xtd::mapped_vector<uint32_t, 3>>(file.path);
+    EXPECT_EQ(100000u, v.size());
+    size_t i{0};
+    for (auto const& s : v.segments())
+      for (auto e : s) EXPECT_EQ(3 * i++, e);
+    EXPECT_EQ(100000u, i);
+
+    for (uint32_t i = 100000; i < 150000; ++i) v.push(i * 3);
+  }
+  auto v = open<xtd::mapped_vector<uint32_t, 3>>(file.path);
+  EXPECT_EQ(150000u, v.size());
+  EXPECT_EQ(xtd::some(size_t{120000}), xtd::simd::find(v, 360000u));
+}
+
+TEST(mapped_vector, rejects_other_layouts) {
+  temporary_path file;
+  open<xtd::mapped_vector<uint32_t, 3>>(file.path).push(1u);
+  using wider = xtd::mapped_vector<uint64_t, 3>;
+  using shorter = xtd::mapped_vector<uint32_t, 2>;
+  using same = xtd::mapped_vector<uint32_t, 3>;
+  EXPECT_FALSE(opens<wider>(file.path));
+  EXPECT_FALSE(opens<shorter>(file.path));
+  EXPECT_TRUE(opens<same>(file.path));
+  EXPECT_FALSE(opens<xtd::mapped_vector<uint32_t>>("/nonexistent/dir/file"));
+}
+
+// A data offset that overlaps the header or is not page aligned would map
+// block 0 over the header, or not map at all.
+TEST(mapped_vector, rejects_bad_data_offset) {
+  using vector = xtd::mapped_vector<uint32_t, 3>;
+  temporary_path file;
+  open<vector>(file.path).push(1u);
+
+  // the fifth field of the header
+  const long field = 4 * sizeof(uint64_t);
+  auto write_offset = [&](uint64_t offset) {
+    FILE* f = std::fopen(file.path.c_str(), "r+b");
+    ASSERT_NE(nullptr, f);
+    std::fseek(f, field, SEEK_SET);
+    std::fwrite(&offset, sizeof(offset), 1, f);
+    std::fclose(f);
+  };
+  const uint64_t page = sysconf(_SC_PAGESIZE);
+  write_offset(0);
+  EXPECT_FALSE(opens<vector>(file.path));
+  write_offset(8);
+  EXPECT_FALSE(opens<vector>(file.path));
+  write_offset(page + 8);
+  EXPECT_FALSE(opens<vector>(file.path));
+  write_offset(page);
+  EXPECT_TRUE(opens<vector>(file.path));
+}
+
+TEST(mapped_vector, rejects_bad_block_count) {
+  using vector = xtd::mapped_vector<uint32_t, 3>;
+  temporary_path file;
+  open<vector>(file.path).push(1u);
+
+  // the sixth field of the header
+  const long field = 5 * sizeof(uint64_t);
+  auto write_blocks = [&](uint64_t blocks) {
+    FILE* f = std::fopen(file.path.c_str(), "r+b");
+    ASSERT_NE(nullptr, f);
+    std::fseek(f, field, SEEK_SET);
+    std::fwrite(&blocks, sizeof(blocks), 1, f);
+    std::fclose(f);
+  };
+  write_blocks(uint64_t{1} << 40);
+  EXPECT_FALSE(opens<vector>(file.path));
+  write_blocks(UINT64_MAX);
+  EXPECT_FALSE(opens<vector>(file.path));
+  // more blocks than the file holds, though few enough to compute with
+  write_blocks(1000);
+  EXPECT_FALSE(opens<vector>(file.path));
+  write_blocks(1);
+  EXPECT_TRUE(opens<vector>(file.path));
+}
+
+TEST(mapped_vector, flush) {
+  temporary_path file;
+  auto v = xtd::mapped_vector<double>::open(file.path.c_str(),
+                                            xtd::mapped_sync::on_close);
+  v.match(
+      [](xtd::mapped_vector<double>& v) {
+        for (int i = 0; i < 100; ++i) v.push(i * 0.5);
+        EXPECT_TRUE(v.flush());
+      },
+      []() { ADD_FAILURE() << "The file was created."; });
+}
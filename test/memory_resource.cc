@@ -0,0 +1,176 @@
+#include <xtd/huge_page_resource.hh>
+#include <xtd/memory_resource.hh>
+#include <xtd/simd_algorithms.hh>
+#include <xtd/vector.hh>
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+namespace {
+class counting_resource : public xtd::memory_resource {
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    outstanding += bytes;
+    return xtd::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    ++deallocations;
+    outstanding -= bytes;
+    xtd::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+ public:
+  int allocations{0};
+  int deallocations{0};
+  size_t outstanding{0};
+};
+
+bool aligned(void* p, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+}
+
+TEST(memory_resource, new_delete_over_aligned) {
+  auto resource = xtd::new_delete_resource();
+  void* p = resource->allocate(100, 256);
+  EXPECT_TRUE(aligned(p, 256));
+  resource->deallocate(p, 100, 256);
+  EXPECT_TRUE(resource->is_equal(*xtd::new_delete_resource()));
+}
+
+TEST(memory_resource, monotonic_buffer) {
+  counting_resource upstream;
+  {
+    alignas(16) char buffer[64];
+    xtd::monotonic_buffer_resource arena{buffer, sizeof(buffer), &upstream};
+
+    void* a = arena.allocate(24, 8);
+    void* b = arena.allocate(16, 16);
+    EXPECT_EQ(buffer, a);
+    EXPECT_TRUE(aligned(b, 16));
+    EXPECT_EQ(0, upstream.allocations);
+
+    void* c = arena.allocate(1000, 64);
+    EXPECT_TRUE(aligned(c, 64));
+    EXPECT_EQ(1, upstream.allocations);
+    arena.deallocate(c, 1000, 64);
+    EXPECT_EQ(0, upstream.deallocations);
+
+    arena.release();
+    EXPECT_EQ(0u, upstream.outstanding);
+    EXPECT_EQ(buffer, arena.allocate(8, 8));
+
+    arena.allocate(4096);
+    arena.allocate(4096);
+  }
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+  EXPECT_EQ(0u, upstream.outstanding);
+}
+
+TEST(memory_resource, vector_blocks) {
+  counting_resource resource;
+  {
+    xtd::vector<int> v{&resource};
+    EXPECT_EQ(&resource, v.resource());
+    EXPECT_EQ(0, resource.allocations);
+
+    for (int i = 0; i < 1000; ++i) v.push(i);
+    EXPECT_LT(1, resource.allocations);
+    EXPECT_EQ(v[999], xtd::some(999));
+
+    while (v.size() > 1) v.pop();
+    EXPECT_LT(0, resource.deallocations);
+    v.reserve(1000);
+  }
+  EXPECT_EQ(resource.allocations, resource.deallocations);
+  EXPECT_EQ(0u, resource.outstanding);
+}
+
+TEST(memory_resource, vector_in_arena) {
+  xtd::monotonic_buffer_resource arena;
+  xtd::vector<int, 3> v{&arena};
+  for (int i = 0; i < 1000; ++i) v.push(i);
+
+  int expected{0};
+  for (auto i : v) EXPECT_EQ(expected++, i);
+  EXPECT_EQ(1000, expected);
+}
+
+TEST(memory_resource, huge_page_alignment) {
+  counting_resource upstream;
+  {
+    xtd::huge_page_resource resource{xtd::huge_page_resource::huge_page_size,
+                                     &upstream};
+    void* small = resource.allocate(100, 8);
+    EXPECT_TRUE(aligned(small, xtd::huge_page_resource::cache_line_size));
+    EXPECT_EQ(1, upstream.allocations);
+
+    const size_t large = 3 * xtd::huge_page_resource::huge_page_size + 100;
+    auto p = static_cast<char*>(resource.allocate(large, 8));
+    EXPECT_TRUE(aligned(p, xtd::huge_page_resource::huge_page_size));
+    EXPECT_EQ(1, upstream.allocations);
+    p[0] = 1;
+    p[large - 1] = 2;
+    EXPECT_EQ(1 + 2, p[0] + p[large - 1]);
+
+    EXPECT_EQ(4 * xtd::huge_page_resource::huge_page_size,
+              resource.mapped_bytes());
+
+    resource.deallocate(p, large, 8);
+    EXPECT_EQ(0u, resource.mapped_bytes());
+    resource.deallocate(small, 100, 8);
+    EXPECT_TRUE(resource.is_equal(resource));
+    EXPECT_FALSE(resource.is_equal(*xtd::new_delete_resource()));
+  }
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+  EXPECT_EQ(0u, upstream.outstanding);
+}
+
+// Blocks smaller than a huge page share chunks, one size per chunk, and are
+// reused once freed.
+TEST(memory_resource, huge_page_chunks) {
+  counting_resource upstream;
+  {
+    constexpr size_t chunk = xtd::huge_page_resource::huge_page_size;
+    xtd::huge_page_resource resource{size_t{4} << 10, &upstream};
+    void* a = resource.allocate(40000, 8);
+    void* b = resource.allocate(size_t{64} << 10, 8);
+    EXPECT_EQ(chunk, resource.mapped_bytes());
+    EXPECT_TRUE(aligned(a, size_t{64} << 10));
+    EXPECT_EQ(static_cast<char*>(a) + (size_t{64} << 10), b);
+
+    resource.deallocate(a, 40000, 8);
+    EXPECT_EQ(a, resource.allocate(size_t{64} << 10, 8));
+    void* c = resource.allocate(size_t{1} << 20, 8);
+    EXPECT_TRUE(aligned(c, chunk));
+    void* d = resource.allocate((size_t{1} << 20) + 1, 8);
+    EXPECT_TRUE(aligned(d, chunk));
+    EXPECT_EQ(3 * chunk, resource.mapped_bytes());
+    EXPECT_EQ(0, upstream.allocations);
+
+    resource.deallocate(d, (size_t{1} << 20) + 1, 8);
+    resource.deallocate(c, size_t{1} << 20, 8);
+    resource.deallocate(b, size_t{64} << 10, 8);
+    resource.deallocate(a, size_t{64} << 10, 8);
+    EXPECT_EQ(2 * chunk, resource.mapped_bytes());
+  }
+  EXPECT_EQ(0, upstream.allocations);
+}
+
+TEST(memory_resource, vector_on_huge_pages) {
+  xtd::huge_page_resource resource;
+  xtd::vector<int64_t, 4> v{&resource};
+  const int64_t n = 1 << 20;
+  for (int64_t i = 0; i < n; ++i) v.push(i);
+  EXPECT_LT(0u, resource.mapped_bytes());
+
+  // the first data block is inline and does not come from the resource
+  v.for_each_span(16, v.size(), [](xtd::span<int64_t> s) {
+    EXPECT_TRUE(aligned(s.data, xtd::huge_page_resource::cache_line_size));
+  });
+  EXPECT_EQ(v[n - 1], xtd::some(n - 1));
+  EXPECT_EQ(n * (n - 1) / 2, xtd::simd::sum(v));
+  while (!v.empty()) v.pop();
+}
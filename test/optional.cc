@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <xtd/optional.hh>
 #include <xtd/call_tracker.hh>
+#include "call_tracker.hh"
 
 TEST(optional, some) {
   const int i = 10;
@@ -201,10 +202,27 @@ TEST(optional, move_construction) {
   EXPECT_EQ(1, move_constructed_b);
   EXPECT_EQ(0, copy_constructed_a);
   EXPECT_EQ(0, copy_constructed_b);
-  EXPECT_EQ(1, moved_from_destroyed);
+  EXPECT_EQ(2, moved_from_destroyed);
   EXPECT_EQ(1, destroyed);
 }
 
+// The optional moved from is left empty, and the value it held is destroyed
+// right away rather than never.
+TEST(optional, move_construction_destroys_source) {
+  xtd_test::lifetime_counter counter;
+  {
+    auto a = xtd::some(counter.prototype());
+    EXPECT_EQ(1, counter.alive());
+    xtd::optional<xtd::call_tracker> b{std::move(a)};
+    EXPECT_EQ(1, counter.alive());
+    a.match([](xtd::call_tracker&) { ADD_FAILURE() << "a was moved from."; },
+            []() {});
+    xtd::optional<xtd::call_tracker> c{std::move(b)};
+    EXPECT_EQ(1, counter.alive());
+  }
+  EXPECT_EQ(0, counter.alive());
+}
+
 TEST(optional, move) {
   int moved_into{0};
   int moved_to{0};
@@ -0,0 +1,76 @@
+#include <xtd/parallel_algorithms.hh>
+#include <xtd/vector.hh>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+xtd::vector<int, 4> iota(int n) {
+  xtd::vector<int, 4> v;
+  for (int i = 0; i < n; ++i) v.push(i);
+  return v;
+}
+}
+
+TEST(parallel_algorithms, for_each) {
+  auto v = iota(300000);
+  xtd::parallel_for_each(v, [](int& i) { i *= 2; }, 4);
+
+  int expected{0};
+  for (auto i : v) {
+    EXPECT_EQ(expected, i);
+    expected += 2;
+  }
+  EXPECT_EQ(600000, expected);
+}
+
+TEST(parallel_algorithms, transform) {
+  auto const v = iota(200000);
+  xtd::vector<long> squares;
+  squares.append_n(v.size(), 0);
+
+  xtd::parallel_transform(v, squares, [](int i) { return long{i} * i; }, 3);
+  long expected{0};
+  for (auto s : squares) {
+    EXPECT_EQ(expected * expected, s);
+    ++expected;
+  }
+}
+
+TEST(parallel_algorithms, reduce) {
+  auto const v = iota(300000);
+  auto const sum = [](long a, long b) { return a + b; };
+  EXPECT_EQ(300000l * 299999 / 2, xtd::parallel_reduce(v, 0l, sum, 1));
+  EXPECT_EQ(300000l * 299999 / 2 + 7, xtd::parallel_reduce(v, 7l, sum, 8));
+  EXPECT_EQ(7, xtd::parallel_reduce(xtd::vector<int>{}, 7, sum));
+}
+
+TEST(parallel_algorithms, reduce_is_deterministic) {
+  xtd::vector<double> v;
+  for (int i = 0; i < 500000; ++i) v.push(1.0 / (i + 1));
+
+  auto const sum = [](double a, double b) { return a + b; };
+  const double one = xtd::parallel_reduce(v, 0.0, sum, 1);
+  for (size_t threads : {2, 3, 8, 16}) {
+    EXPECT_EQ(one, xtd::parallel_reduce(v, 0.0, sum, threads));
+  }
+
+  // Associative but not commutative: the chunks are combined in order.
+  xtd::vector<std::string> letters;
+  for (int i = 0; i < 100000; ++i) letters.push(1, char('a' + i % 26));
+  auto const text = xtd::parallel_reduce(
+      letters, std::string{}, [](std::string a, std::string const& b) {
+        return a += b;
+      }, 4);
+  ASSERT_EQ(100000u, text.size());
+  for (size_t i = 0; i < text.size(); ++i)
+    EXPECT_EQ(char('a' + i % 26), text[i]);
+}
+
+TEST(parallel_algorithms, count_if) {
+  auto const v = iota(250000);
+  auto const even = [](int i) { return i % 2 == 0; };
+  EXPECT_EQ(125000u, xtd::parallel_count_if(v, even, 1));
+  EXPECT_EQ(125000u, xtd::parallel_count_if(v, even, 5));
+}
@@ -0,0 +1,153 @@
+#include <xtd/serialization.hh>
+
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+struct record {
+  uint32_t id;
+  uint16_t kind;
+  uint8_t flags;
+};
+
+// An unlinked temporary file, closed when it goes out of scope.
+struct temporary_file {
+  int fd;
+
+  temporary_file() {
+    char path[] = "/tmp/xtd_serialization_XXXXXX";
+    fd = mkstemp(path);
+    unlink(path);
+  }
+
+  ~temporary_file() { close(fd); }
+
+  void rewind() { lseek(fd, 0, SEEK_SET); }
+};
+}
+
+TEST(serialization, round_trip) {
+  xtd::vector<record, 2> v;
+  for (uint32_t i = 0; i < 10000; ++i)
+    v.push(record{i, static_cast<uint16_t>(i % 7), static_cast<uint8_t>(i)});
+
+  temporary_file file;
+  ASSERT_TRUE(xtd::write_to(file.fd, v));
+  file.rewind();
+
+  // the stream does not depend on the segment size
+  xtd::vector<record, 5> u;
+  u.push(record{42, 0, 0});
+  ASSERT_TRUE(xtd::read_from(file.fd, u));
+  ASSERT_EQ(10001u, u.size());
+  EXPECT_EQ(42u, u.begin()->id);
+  for (uint32_t i = 0; i < 10000; ++i) {
+    auto const& r = u.begin()[i + 1];
+    EXPECT_EQ(i, r.id);
+    EXPECT_EQ(i % 7, r.kind);
+    EXPECT_EQ(static_cast<uint8_t>(i), r.flags);
+  }
+}
+
+TEST(serialization, checksum) {
+  xtd::vector<uint64_t> v;
+  for (uint64_t i = 0; i < 5000; ++i) v.push(i * i);
+
+  temporary_file file;
+  ASSERT_TRUE(xtd::write_to(file.fd, v, xtd::checksum_mode::verify));
+
+  file.rewind();
+  xtd::vector<uint64_t> u;
+  ASSERT_TRUE(xtd::read_from(file.fd, u));
+  EXPECT_EQ(5000u, u.size());
+
+  // flip a bit of the last element
+  const off_t last = sizeof(xtd::serialization_header) + 4999 * 8;
+  uint64_t word;
+  ASSERT_EQ(8, pread(file.fd, &word, 8, last));
+  word ^= 1;
+  ASSERT_EQ(8, pwrite(file.fd, &word, 8, last));
+
+  file.rewind();
+  xtd::vector<uint64_t> w;
+  w.push(7);
+  EXPECT_FALSE(xtd::read_from(file.fd, w));
+  EXPECT_EQ(1u, w.size());
+}
+
+TEST(serialization, rejects_other_streams) {
+  xtd::vector<uint32_t> v;
+  v.push(1u);
+
+  temporary_file file;
+  ASSERT_TRUE(xtd::write_to(file.fd, v));
+  file.rewind();
+  xtd::vector<uint64_t> wider;
+  EXPECT_FALSE(xtd::read_from(file.fd, wider));
+
+  // the stream ends before its elements
+  ASSERT_EQ(0, ftruncate(file.fd, sizeof(xtd::serialization_header) + 2));
+  file.rewind();
+  xtd::vector<uint32_t> u;
+  EXPECT_FALSE(xtd::read_from(file.fd, u));
+  EXPECT_TRUE(u.empty());
+}
+
+// A corrupt size fails without allocating for it, whether the stream can be
+// measured or not.
+TEST(serialization, rejects_bogus_sizes) {
+  xtd::vector<uint64_t> v;
+  for (uint64_t i = 0; i < 1000; ++i) v.push(i);
+  xtd::serialization_header header{xtd::serialization_header::magic_value,
+                                   sizeof(uint64_t),
+                                   uint64_t{1} << 45,
+                                   0,
+                                   0,
+                                   {},
+                                   0};
+
+  temporary_file file;
+  ASSERT_EQ(ssize_t(sizeof(header)), write(file.fd, &header, sizeof(header)));
+  file.rewind();
+  EXPECT_FALSE(xtd::read_from(file.fd, v));
+  EXPECT_EQ(1000u, v.size());
+
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  ASSERT_EQ(ssize_t(sizeof(header)), write(fds[1], &header, sizeof(header)));
+  ASSERT_EQ(8, write(fds[1], "12345678", 8));
+  close(fds[1]);
+  EXPECT_FALSE(xtd::read_from(fds[0], v));
+  close(fds[0]);
+  EXPECT_EQ(1000u, v.size());
+  EXPECT_EQ(xtd::some(uint64_t{999}), v.back().map([](uint64_t i) {
+    return i;
+  }));
+}
+
+// A pipe only takes part of a large writev at a time.
+TEST(serialization, partial_transfers) {
+  xtd::vector<uint32_t, 3> v;
+  for (uint32_t i = 0; i < 1000000; ++i) v.push(i);
+
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  bool written{false};
+  std::thread writer{[&]() {
+    written = xtd::write_to(fds[1], v, xtd::checksum_mode::verify);
+    close(fds[1]);
+  }};
+  xtd::vector<uint32_t, 1> u;
+  EXPECT_TRUE(xtd::read_from(fds[0], u));
+  writer.join();
+  close(fds[0]);
+
+  EXPECT_TRUE(written);
+  EXPECT_EQ(v.size(), u.size());
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), u.begin()));
+}
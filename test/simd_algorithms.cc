@@ -0,0 +1,97 @@
+#include <xtd/simd_algorithms.hh>
+#include <xtd/vector.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+template <typename T, uint8_t N>
+xtd::vector<T, N> random_vector(size_t n, int seed, int range) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(-range, range);
+  xtd::vector<T, N> v;
+  for (size_t i = 0; i < n; ++i) v.push(static_cast<T>(dist(gen)));
+  return v;
+}
+}
+
+TEST(simd_algorithms, sum) {
+  for (size_t n : {0, 1, 7, 33, 1000, 12345}) {
+    auto const v = random_vector<int8_t, 2>(n, n, 127);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), int64_t{0}),
+              xtd::simd::sum(v));
+
+    auto const u = random_vector<uint32_t, 0>(n, n, 1000);
+    EXPECT_EQ(std::accumulate(u.begin(), u.end(), uint64_t{0}),
+              xtd::simd::sum(u));
+  }
+
+  xtd::vector<double, 3> d;
+  for (int i = 0; i < 1000; ++i) d.push(0.5 * i);
+  EXPECT_DOUBLE_EQ(0.5 * 999 * 1000 / 2, xtd::simd::sum(d));
+}
+
+TEST(simd_algorithms, minmax) {
+  EXPECT_EQ(xtd::simd::minmax(xtd::vector<int>{}),
+            (xtd::optional<std::pair<int, int>>{}));
+
+  for (size_t n : {1, 9, 100, 5000}) {
+    auto const v = random_vector<int16_t, 1>(n, n, 30000);
+    auto const expected = std::minmax_element(v.begin(), v.end());
+    EXPECT_EQ(xtd::simd::minmax(v),
+              xtd::some(std::make_pair(*expected.first, *expected.second)));
+  }
+
+  xtd::vector<float> f;
+  for (int i = 0; i < 100; ++i) f.push(float(i % 17) - 3.5f);
+  EXPECT_EQ(xtd::simd::minmax(f), xtd::some(std::make_pair(-3.5f, 12.5f)));
+}
+
+TEST(simd_algorithms, find_and_count) {
+  auto const v = random_vector<int32_t, 3>(10000, 42, 50);
+  for (int32_t value : {-50, -3, 0, 17, 50, 51}) {
+    auto const it = std::find(v.begin(), v.end(), value);
+    if (it == v.end())
+      EXPECT_EQ(xtd::simd::find(v, value), xtd::optional<size_t>{});
+    else
+      EXPECT_EQ(xtd::simd::find(v, value),
+                xtd::some(size_t(it - v.begin())));
+    EXPECT_EQ(size_t(std::count(v.begin(), v.end(), value)),
+              xtd::simd::count(v, value));
+  }
+}
+
+TEST(simd_algorithms, equal) {
+  auto const a = random_vector<int64_t, 0>(3000, 7, 1000);
+  auto b = random_vector<int64_t, 4>(3000, 7, 1000);
+  EXPECT_TRUE(xtd::simd::equal(a, b));
+
+  b.pop();
+  EXPECT_FALSE(xtd::simd::equal(a, b));
+  b.push(1001);
+  EXPECT_FALSE(xtd::simd::equal(a, b));
+  EXPECT_TRUE(xtd::simd::equal(xtd::vector<int>{}, xtd::vector<int, 2>{}));
+}
+
+TEST(simd_algorithms, lexicographical_compare) {
+  auto const a = random_vector<double, 2>(2000, 11, 1000);
+  auto b = random_vector<double, 1>(2000, 11, 1000);
+  EXPECT_FALSE(xtd::simd::lexicographical_compare(a, b));
+  EXPECT_FALSE(xtd::simd::lexicographical_compare(b, a));
+
+  b.push(0.0);
+  EXPECT_TRUE(xtd::simd::lexicographical_compare(a, b));
+  EXPECT_FALSE(xtd::simd::lexicographical_compare(b, a));
+
+  b.begin()[1500] += 1;
+  EXPECT_TRUE(xtd::simd::lexicographical_compare(a, b));
+  EXPECT_FALSE(xtd::simd::lexicographical_compare(b, a));
+  EXPECT_EQ(std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                         b.end()),
+            xtd::simd::lexicographical_compare(a, b));
+}
@@ -0,0 +1,93 @@
+#include <xtd/call_tracker.hh>
+#include <xtd/soa_vector.hh>
+#include <xtd/simd_algorithms.hh>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "call_tracker.hh"
+
+TEST(soa_vector, push_pop) {
+  xtd::soa_vector<int, std::string, double> v;
+  EXPECT_TRUE(v.empty());
+  for (int i = 0; i < 100; ++i) v.push(i, std::to_string(i), i * 0.5);
+  EXPECT_EQ(100u, v.size());
+
+  v[42].match(
+      [](auto row) {
+        EXPECT_EQ(42, std::get<0>(row));
+        EXPECT_EQ("42", std::get<1>(row));
+        EXPECT_DOUBLE_EQ(21.0, std::get<2>(row));
+      },
+      []() { ADD_FAILURE() << "The row was pushed."; });
+  v[100].match([](auto) { ADD_FAILURE() << "Out of bounds."; }, []() {});
+
+  EXPECT_EQ(xtd::some(std::make_tuple(99, std::string{"99"}, 49.5)), v.pop());
+  v.back().match([](auto row) { EXPECT_EQ(98, std::get<0>(row)); },
+                 []() { ADD_FAILURE() << "The vector is not empty."; });
+  while (v.pop().match([](auto const&) { return true; },
+                       []() { return false; })) {
+  }
+  EXPECT_TRUE(v.empty());
+  v.push(7, "seven", 7.0);
+  EXPECT_EQ(1u, v.size());
+}
+
+// Assigning through the row proxy writes to the columns.
+TEST(soa_vector, proxy_reference) {
+  xtd::soa_vector<int, float> v;
+  for (int i = 0; i < 10; ++i) v.push(i, 0.0f);
+  v[3].match([](auto row) { row = std::make_tuple(-3, 1.5f); }, []() {});
+  v[4].match([](auto row) { std::get<1>(row) = 2.5f; }, []() {});
+
+  xtd::soa_vector<int, float> const& c = v;
+  c[3].match(
+      [](auto row) {
+        EXPECT_EQ(-3, std::get<0>(row));
+        EXPECT_FLOAT_EQ(1.5f, std::get<1>(row));
+      },
+      []() { ADD_FAILURE() << "The row was pushed."; });
+  c[4].match([](auto row) { EXPECT_FLOAT_EQ(2.5f, std::get<1>(row)); },
+             []() { ADD_FAILURE() << "The row was pushed."; });
+}
+
+TEST(soa_vector, columns) {
+  xtd::basic_soa_vector<2, uint8_t, int64_t, double> v;
+  for (int64_t i = 0; i < 10000; ++i)
+    v.push(static_cast<uint8_t>(i), i, 0.25 * i);
+
+  size_t rows{0};
+  int64_t expected{0};
+  for (auto const& s : v.column<1>().segments()) {
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(s.data) % 64);
+    for (auto e : s) EXPECT_EQ(expected++, e);
+    rows += s.size;
+  }
+  EXPECT_EQ(10000u, rows);
+
+  EXPECT_EQ(int64_t{9999} * 10000 / 2, xtd::simd::sum(v.column<1>()));
+  EXPECT_EQ(xtd::some(size_t{4000}), xtd::simd::find(v.column<2>(), 1000.0));
+  EXPECT_EQ(xtd::some(std::make_pair(int64_t{0}, int64_t{9999})),
+            xtd::simd::minmax(v.column<1>()));
+  EXPECT_EQ(xtd::some(std::make_pair(0.0, 2499.75)),
+            xtd::simd::minmax(v.column<2>()));
+
+  v.for_each_span<0>([](xtd::span<uint8_t> s) {
+    for (auto& e : s) e = 1;
+  });
+  EXPECT_EQ(10000u, xtd::simd::sum(v.column<0>()));
+}
+
+TEST(soa_vector, destroys_fields) {
+  xtd_test::lifetime_counter counter;
+  {
+    xtd::soa_vector<int, xtd::call_tracker> v;
+    for (int i = 0; i < 50; ++i) v.push(i, counter.prototype());
+    v.pop();
+    EXPECT_EQ(49, counter.alive());
+  }
+  EXPECT_EQ(0, counter.alive());
+}
@@ -0,0 +1,124 @@
+#include <xtd/sort.hh>
+#include <xtd/vector.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+template <typename T, uint8_t N, typename Generator>
+void fill(xtd::vector<T, N>& v, std::vector<T>& expected, size_t n,
+          Generator gen) {
+  for (size_t i = 0; i < n; ++i) {
+    const T t = gen();
+    v.push(t);
+    expected.push_back(t);
+  }
+}
+
+template <typename Vector, typename T>
+void expect_elements(Vector const& v, std::vector<T> const& expected) {
+  ASSERT_EQ(expected.size(), v.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), v.begin()));
+}
+}
+
+TEST(sort, sort) {
+  std::mt19937 random{1};
+  for (size_t n : {0, 1, 2, 3, 100, 10000}) {
+    xtd::vector<int, 2> v;
+    std::vector<int> expected;
+    fill(v, expected, n, [&random]() { return int(random() % 1000); });
+    xtd::sort(v);
+    std::sort(expected.begin(), expected.end());
+    expect_elements(v, expected);
+  }
+}
+
+TEST(sort, comparator) {
+  std::mt19937 random{2};
+  xtd::vector<std::string> v;
+  std::vector<std::string> expected;
+  fill(v, expected, 5000,
+       [&random]() { return std::to_string(random() % 100000); });
+  xtd::sort(v, std::greater<>{});
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  expect_elements(v, expected);
+}
+
+TEST(sort, parallel_sort) {
+  std::mt19937_64 random{3};
+  xtd::vector<uint64_t> v;
+  std::vector<uint64_t> expected;
+  fill(v, expected, 300000, [&random]() { return random() % 5000; });
+  xtd::parallel_sort(v, std::less<>{}, 4);
+  std::sort(expected.begin(), expected.end());
+  expect_elements(v, expected);
+}
+
+TEST(sort, radix_sort_integers) {
+  std::mt19937_64 random{4};
+  xtd::vector<int64_t, 3> v;
+  std::vector<int64_t> expected;
+  fill(v, expected, 100000, [&random]() { return int64_t(random()); });
+  v.push(std::numeric_limits<int64_t>::min());
+  expected.push_back(std::numeric_limits<int64_t>::min());
+  xtd::radix_sort(v);
+  std::sort(expected.begin(), expected.end());
+  expect_elements(v, expected);
+
+  // only the low byte differs, so all but one pass are skipped
+  xtd::vector<uint32_t> u;
+  std::vector<uint32_t> small;
+  fill(u, small, 1000, [&random]() { return uint32_t(random() % 200); });
+  xtd::radix_sort(u);
+  std::sort(small.begin(), small.end());
+  expect_elements(u, small);
+}
+
+namespace {
+template <typename V, typename = void>
+struct radix_sortable : std::false_type {};
+
+template <typename V>
+struct radix_sortable<V, decltype(xtd::radix_sort(std::declval<V&>()))>
+    : std::true_type {};
+}
+
+static_assert(radix_sortable<xtd::vector<int8_t>>::value &&
+                  radix_sortable<xtd::vector<uint64_t>>::value &&
+                  radix_sortable<xtd::vector<float>>::value &&
+                  radix_sortable<xtd::vector<double>>::value,
+              "Integers of up to 64 bits and float and double have keys.");
+static_assert(!radix_sortable<xtd::vector<long double>>::value &&
+                  !radix_sortable<xtd::vector<bool>>::value &&
+                  !radix_sortable<xtd::vector<std::string>>::value,
+              "Elements without a key of at most 64 bits are rejected.");
+
+TEST(sort, radix_sort_floating_point) {
+  std::mt19937 random{5};
+  std::uniform_real_distribution<double> dist{-1e6, 1e6};
+  xtd::vector<double> v;
+  std::vector<double> expected;
+  fill(v, expected, 50000, [&]() { return dist(random); });
+  for (double d : {0.0, -0.5, std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity()}) {
+    v.push(d);
+    expected.push_back(d);
+  }
+  xtd::radix_sort(v);
+  std::sort(expected.begin(), expected.end());
+  expect_elements(v, expected);
+
+  xtd::vector<float, 1> f;
+  for (float x : {3.5f, -2.0f, 0.25f, -7.75f}) f.push(x);
+  xtd::radix_sort(f);
+  expect_elements(f, std::vector<float>{-7.75f, -2.0f, 0.25f, 3.5f});
+}
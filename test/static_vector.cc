@@ -0,0 +1,93 @@
+#include <xtd/call_tracker.hh>
+#include <xtd/simd_algorithms.hh>
+#include <xtd/static_vector.hh>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "call_tracker.hh"
+
+static_assert(std::is_trivially_copyable<xtd::static_vector<int, 8>>::value,
+              "A static_vector of trivially copyable elements is too.");
+static_assert(
+    !std::is_trivially_copyable<xtd::static_vector<std::string, 8>>::value,
+    "A static_vector of strings copies them one by one.");
+static_assert(xtd::static_vector<int, 8>::capacity() == 8,
+              "The capacity is a constant expression.");
+static_assert(sizeof(xtd::static_vector<uint8_t, 14>) == 16,
+              "The size is counted in the narrowest type that fits.");
+
+TEST(static_vector, push_pop) {
+  xtd::static_vector<std::string, 4> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, v.pop());
+  v.back().match([](std::string&) { ADD_FAILURE() << "The vector is empty."; },
+                 []() {});
+
+  EXPECT_TRUE(v.push("a"));
+  EXPECT_TRUE(v.push(3, 'b'));
+  EXPECT_TRUE(v.push("c"));
+  EXPECT_TRUE(v.push("d"));
+  EXPECT_TRUE(v.full());
+  EXPECT_FALSE(v.push("e"));
+  EXPECT_EQ(4u, v.size());
+
+  v[1].match([](std::string const& s) { EXPECT_EQ("bbb", s); },
+             []() { ADD_FAILURE() << "The element was pushed."; });
+  v[4].match([](std::string const&) { ADD_FAILURE() << "Out of bounds."; },
+             []() {});
+  v.back().match([](std::string& s) { s = "z"; }, []() {});
+
+  EXPECT_EQ(xtd::some(std::string{"z"}), v.pop());
+  EXPECT_EQ(xtd::some(std::string{"c"}), v.pop());
+  EXPECT_EQ(2u, v.size());
+  v.clear();
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(static_vector, copy_and_move) {
+  xtd::static_vector<std::string, 8> v;
+  for (int i = 0; i < 5; ++i) v.push(std::to_string(i));
+
+  auto copy = v;
+  auto moved = std::move(copy);
+  xtd::static_vector<std::string, 8> assigned;
+  assigned.push("x");
+  assigned = moved;
+  for (auto const* w : {&v, &moved, &assigned}) {
+    ASSERT_EQ(5u, w->size());
+    int expected{0};
+    for (auto const& s : *w) EXPECT_EQ(std::to_string(expected++), s);
+  }
+
+  // trivially copyable elements are copied as bytes
+  xtd::static_vector<int64_t, 16> ints;
+  for (int64_t i = 0; i < 10; ++i) ints.push(i);
+  xtd::static_vector<int64_t, 16> raw;
+  std::memcpy(&raw, &ints, sizeof(raw));
+  EXPECT_EQ(10u, raw.size());
+  EXPECT_EQ(45, xtd::simd::sum(raw));
+  EXPECT_TRUE(xtd::simd::equal(raw, ints));
+}
+
+TEST(static_vector, destroys_elements) {
+  xtd_test::lifetime_counter counter;
+  {
+    xtd::static_vector<xtd::call_tracker, 32> v;
+    for (int i = 0; i < 32; ++i) v.push(counter.prototype());
+    EXPECT_FALSE(v.push(counter.prototype()));
+    EXPECT_EQ(32, counter.alive());
+    v.pop();
+    auto copy = v;
+    copy.clear();
+    v = std::move(copy);
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(0, counter.alive());
+    for (int i = 0; i < 10; ++i) v.push(counter.prototype());
+  }
+  EXPECT_EQ(0, counter.alive());
+}
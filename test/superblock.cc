@@ -0,0 +1,78 @@
+#include <xtd/superblock.hh>
+#include <xtd/vector.hh>
+
+#include <gtest/gtest.h>
+
+namespace {
+namespace superblock = xtd::superblock;
+
+constexpr bool operator==(superblock::location const& a,
+                          superblock::location const& b) {
+  return a.superblock == b.superblock && a.block == b.block &&
+         a.segment == b.segment && a.length == b.length;
+}
+
+// Walks the first `count` segments one at a time, the way vector::grow does,
+// and checks that locate finds each of them.
+constexpr bool locates_in_order(size_t count) {
+  superblock::location expected{0, 0, 0, 1};
+  size_t blocks_left{1};
+  for (size_t pos = 0; pos < count; ++pos) {
+    if (!(superblock::locate(pos) == expected)) return false;
+    if (++expected.segment == expected.length) {
+      expected.segment = 0;
+      ++expected.block;
+      if (--blocks_left == 0) {
+        ++expected.superblock;
+        blocks_left = superblock::blocks(expected.superblock);
+        expected.length = superblock::length(expected.superblock);
+      }
+    }
+  }
+  return true;
+}
+}
+
+static_assert(locates_in_order(1 << 12), "");
+
+static_assert(superblock::log2(1) == 0, "");
+static_assert(superblock::log2(uint64_t{1} << 63) == 63, "");
+
+static_assert(superblock::locate(0) == superblock::location{0, 0, 0, 1}, "");
+static_assert(superblock::locate(1) == superblock::location{1, 1, 0, 2}, "");
+static_assert(superblock::locate(2) == superblock::location{1, 1, 1, 2}, "");
+static_assert(superblock::locate(3) == superblock::location{2, 2, 0, 2}, "");
+static_assert(superblock::locate(6) == superblock::location{2, 3, 1, 2}, "");
+static_assert(superblock::locate(7) == superblock::location{3, 4, 0, 4}, "");
+
+static_assert(superblock::block_length(0) == 1, "");
+static_assert(superblock::block_length(1) == 2, "");
+static_assert(superblock::block_length(4) == 4, "");
+static_assert(superblock::segments_in(0) == 0, "");
+static_assert(superblock::segments_in(4) == 7, "");
+static_assert(superblock::segments_in(superblock::first_block(10)) ==
+                  (1 << 10) - 1,
+              "");
+
+static_assert(xtd::segment_bits<char>(64) == 6, "");
+static_assert(xtd::segment_bits<double>(64) == 3, "");
+static_assert(xtd::segment_bits<char[48]>(64) == 0, "");
+static_assert(xtd::segment_bits<char[100]>(64) == 0, "");
+static_assert(xtd::cache_line_segment<int> == 4, "");
+static_assert(xtd::page_segment<int> == 10, "");
+
+TEST(superblock, locate_matches_block_geometry) {
+  for (size_t b = 0; b < 1000; ++b) {
+    const size_t first = superblock::segments_in(b);
+    const auto loc = superblock::locate(first);
+    EXPECT_EQ(b, loc.block);
+    EXPECT_EQ(0u, loc.segment);
+    EXPECT_EQ(superblock::block_length(b), loc.length);
+  }
+}
+
+TEST(superblock, cache_line_segments) {
+  xtd::vector<int, xtd::cache_line_segment<int>> v;
+  for (int i = 0; i < 1024; ++i) v.push(i);
+  for (auto const& s : v.segments()) EXPECT_EQ(0u, s.size % 16);
+}
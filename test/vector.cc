@@ -1,7 +1,20 @@
+#include <sys/mman.h>
+
+#include <xtd/call_tracker.hh>
 #include <xtd/vector.hh>
 
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "allocation_counter.hh"
+#include "call_tracker.hh"
+
 TEST(vector, constructor) { xtd::vector<int> v; }
 
 TEST(vector, push) {
@@ -75,3 +88,434 @@ TEST(vector, empty) {
   v.pop();
   EXPECT_EQ(v.empty(), true);
 }
+
+TEST(vector, append) {
+  std::vector<int> source(1000);
+  std::iota(source.begin(), source.end(), 0);
+
+  xtd::vector<int, 2> v;
+  v.push(-1);
+  v.append(source.data(), source.data() + source.size())
+      .append(source.begin(), source.begin() + 10);
+
+  ASSERT_EQ(1011u, v.size());
+  EXPECT_EQ(v[0], xtd::some(-1));
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(v[i + 1], xtd::some(i));
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(v[i + 1001], xtd::some(i));
+
+  std::istringstream in{"1 2 3"};
+  v.append(std::istream_iterator<int>{in}, std::istream_iterator<int>{});
+  ASSERT_EQ(1014u, v.size());
+  EXPECT_EQ(v[1013], xtd::some(3));
+}
+
+TEST(vector, append_n) {
+  xtd::vector<std::string> v;
+  v.append_n(100, "xtd").push("last");
+
+  ASSERT_EQ(101u, v.size());
+  EXPECT_EQ("xtd", v.begin()[0]);
+  EXPECT_EQ("xtd", v.begin()[99]);
+  EXPECT_EQ("last", v.begin()[100]);
+}
+
+TEST(vector, emplace_back_n) {
+  xtd::vector<int, 3> v;
+  int next{0};
+  v.emplace_back_n(500, [&next]() { return next++; });
+  v.emplace_back_n(0, [&next]() { return next++; });
+
+  ASSERT_EQ(500u, v.size());
+  int expected{0};
+  for (auto i : v) EXPECT_EQ(expected++, i);
+
+  v.pop().match([](int i) { EXPECT_EQ(499, i); },
+                []() { ADD_FAILURE() << "The vector should not be empty!"; });
+  v.push(1000);
+  EXPECT_EQ(v[499], xtd::some(1000));
+}
+
+TEST(vector, emplace_back_n_throws) {
+  xtd::vector<int> v;
+  v.push(0);
+  int next{1};
+  EXPECT_THROW(v.emplace_back_n(10,
+                                [&next]() {
+                                  if (next == 6) throw next;
+                                  return next++;
+                                }),
+               int);
+
+  // The runs filled before the exception was thrown are kept.
+  EXPECT_EQ(5u, v.size());
+  v.push(5);
+  int expected{0};
+  for (auto i : v) EXPECT_EQ(expected++, i);
+  EXPECT_EQ(6, expected);
+}
+
+TEST(vector, capacity) {
+  xtd::vector<int, 2> v;
+  EXPECT_EQ(4u, v.capacity());
+
+  for (int i = 0; i < 100; ++i) {
+    v.push(i);
+    EXPECT_LE(v.size(), v.capacity());
+  }
+  while (!v.empty()) v.pop();
+  EXPECT_LE(4u, v.capacity());
+}
+
+TEST(vector, reserve) {
+  xtd::vector<int> v;
+  v.push(-1).reserve(100000);
+  EXPECT_LE(100000u, v.capacity());
+  EXPECT_GT(200000u, v.capacity());
+
+  auto const allocations = xtd_test::allocations();
+  for (int i = 1; i < 100000; ++i) v.push(i);
+  EXPECT_EQ(allocations, xtd_test::allocations());
+
+  EXPECT_EQ(100000u, v.size());
+  EXPECT_EQ(v[0], xtd::some(-1));
+  EXPECT_EQ(v[99999], xtd::some(99999));
+
+  auto const capacity = v.capacity();
+  v.reserve(10);
+  EXPECT_EQ(capacity, v.capacity());
+}
+
+TEST(vector, retention) {
+  // Fills the first six data blocks, then empties them.
+  auto blocks_kept = [](xtd::retention policy) {
+    xtd::vector<int> v;
+    v.retain(policy);
+    for (int i = 0; i < 13; ++i) v.push(i);
+    while (!v.empty()) v.pop();
+    return v.capacity();
+  };
+  // the four inline blocks of 7 elements are never released, and count as
+  // spare ones
+  EXPECT_EQ(7u, blocks_kept(xtd::retention::spare_blocks(0)));
+  EXPECT_EQ(7u, blocks_kept(xtd::retention::spare_blocks(1)));
+  EXPECT_EQ(7u, blocks_kept(xtd::retention::spare_blocks(4)));
+  EXPECT_EQ(15u, blocks_kept(xtd::retention::until_shrink()));
+
+  xtd::vector<int> v;
+  v.retain(xtd::retention::slack_percent(50));
+  for (int i = 0; i < 1000; ++i) v.push(i);
+  while (v.size() > 500) v.pop();
+  EXPECT_GE(750u, v.capacity());
+  EXPECT_LE(500u, v.capacity());
+}
+
+// Pushing and popping across a block boundary does not allocate while the
+// blocks are kept.
+TEST(vector, retention_oscillation) {
+  xtd::vector<int> v;
+  v.retain(xtd::retention::spare_blocks(2));
+  for (int i = 0; i < 1000; ++i) v.push(i);
+  for (int i = 0; i < 40; ++i) v.push(i);
+  for (int i = 0; i < 40; ++i) v.pop();
+
+  auto const allocations = xtd_test::allocations();
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 40; ++i) v.push(i);
+    for (int i = 0; i < 40; ++i) v.pop();
+  }
+  EXPECT_EQ(allocations, xtd_test::allocations());
+  EXPECT_EQ(1000u, v.size());
+}
+
+// The first superblocks live in the vector object, so small vectors do not
+// allocate at all.
+TEST(vector, inline_block) {
+  auto const allocations = xtd_test::allocations();
+  {
+    xtd::vector<int, 3> v;
+    for (int i = 0; i < 8; ++i) v.push(i);
+    EXPECT_EQ(v.back(), xtd::some(7));
+    while (v.size() > 2) v.pop();
+    EXPECT_EQ(0u, v.stats().directory_bytes);
+
+    // with segments of one element, the first three superblocks are inline
+    xtd::vector<int> small;
+    for (int i = 0; i < 7; ++i) small.push(i);
+    EXPECT_EQ(small[6], xtd::some(6));
+    EXPECT_EQ(7u, small.capacity());
+  }
+  EXPECT_EQ(allocations, xtd_test::allocations());
+
+  xtd::vector<std::string, 1> v;
+  for (int i = 0; i < 10; ++i) v.push(std::to_string(i));
+  EXPECT_LT(allocations, xtd_test::allocations());
+
+  auto value = [](auto o) {
+    return o.map([](std::string const& s) { return s; });
+  };
+  xtd::vector<std::string, 1> moved{std::move(v)};
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(10u, moved.size());
+  EXPECT_EQ(xtd::some(std::string{"0"}), value(moved[0]));
+  EXPECT_EQ(xtd::some(std::string{"9"}), value(moved[9]));
+
+  v.push("a");
+  v = std::move(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(xtd::some(std::string{"1"}), value(v[1]));
+  EXPECT_EQ(xtd::some(std::string{"9"}), value(v.back()));
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, value(moved.back()));
+  EXPECT_EQ(xtd::optional<std::string>{xtd::none{}}, moved.pop());
+}
+
+TEST(vector, clear) {
+  xtd::vector<int, 2> v;
+  v.retain(xtd::retention::spare_blocks(2));
+  for (int i = 0; i < 1000; ++i) v.push(i);
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(2u, v.stats().data_blocks);
+  EXPECT_EQ(xtd::optional<int>{xtd::none{}}, v.pop());
+
+  for (int i = 0; i < 10; ++i) v.push(i);
+  EXPECT_EQ(10u, v.size());
+  EXPECT_EQ(v[9], xtd::some(9));
+  EXPECT_EQ(v.back(), xtd::some(9));
+}
+
+TEST(vector, truncate) {
+  xtd::vector<int, 2> v;
+  for (int i = 0; i < 100; ++i) v.push(i);
+  v.truncate(200);
+  EXPECT_EQ(100u, v.size());
+  v.truncate(41);
+  EXPECT_EQ(41u, v.size());
+  EXPECT_EQ(v.back(), xtd::some(40));
+  v.truncate(40);
+  EXPECT_EQ(v.back(), xtd::some(39));
+  v.push(-1);
+  EXPECT_EQ(v[40], xtd::some(-1));
+  v.truncate(0);
+  EXPECT_TRUE(v.empty());
+  v.push(7);
+  EXPECT_EQ(v.back(), xtd::some(7));
+}
+
+// Every element is destroyed exactly once, by pop, clear or the destructor.
+TEST(vector, destroys_elements) {
+  xtd_test::lifetime_counter counter;
+  {
+    xtd::vector<xtd::call_tracker, 2> v;
+    for (int i = 0; i < 100; ++i) v.push(counter.prototype());
+    v.pop();
+    v.clear();
+    EXPECT_EQ(0, counter.alive());
+
+    for (int i = 0; i < 50; ++i) v.push(counter.prototype());
+    xtd::vector<xtd::call_tracker, 2> moved{std::move(v)};
+    v.push(counter.prototype());
+    v = std::move(moved);
+    EXPECT_EQ(50u, v.size());
+    EXPECT_EQ(50, counter.alive());
+  }
+  EXPECT_EQ(0, counter.alive());
+}
+
+// With allocate_ahead, the block after the one being filled is always
+// allocated, so the push that moves into it does not allocate.
+TEST(vector, allocate_ahead) {
+  xtd::vector<int, 1> v;
+  v.allocate_ahead();
+  EXPECT_TRUE(v.allocates_ahead());
+  for (int i = 0; i < 1000; ++i) {
+    v.push(i);
+    EXPECT_LE(1u, v.stats().spare_blocks);
+  }
+  EXPECT_EQ(v[999], xtd::some(999));
+
+  v.allocate_ahead(false);
+  while (v.size() < v.capacity()) v.push(0);
+  EXPECT_EQ(0u, v.stats().spare_blocks);
+  v.allocate_ahead();
+  EXPECT_EQ(1u, v.stats().spare_blocks);
+
+  while (v.size() > 1) v.pop();
+  EXPECT_EQ(v.back(), xtd::some(0));
+}
+
+// The directory never moves the blocks it holds, so references to elements
+// stay put while the vector grows, and its tables are only added to.
+TEST(vector, directory_is_stable) {
+  xtd::vector<int64_t> v;
+  v.push(0);
+  v.push(1);
+  int64_t const* second = &v.begin()[1];
+  for (int64_t i = 2; i < 100000; ++i) v.push(i);
+  EXPECT_EQ(second, &v.begin()[1]);
+
+  const size_t directory_bytes = v.stats().directory_bytes;
+  for (int64_t i = 0; i < 100000; ++i) v.push(i);
+  EXPECT_EQ(v[199999], xtd::some(int64_t{99999}));
+  // only the tables of the new superblocks were added
+  EXPECT_GT(2 * directory_bytes, v.stats().directory_bytes);
+}
+
+// A vector that just left its inline block holds a few dozen bytes rather
+// than room for the directory of the largest possible vector.
+TEST(vector, small_directory) {
+  xtd::vector<int> v;
+  v.push(1).push(2);
+  EXPECT_GT(64u, v.stats().bytes_allocated);
+  EXPECT_EQ(v[1], xtd::some(2));
+}
+
+TEST(vector, shrink_to_fit) {
+  xtd::vector<int> v;
+  v.retain(xtd::retention::until_shrink());
+  for (int i = 0; i < 1000; ++i) v.push(i);
+  while (v.size() > 10) v.pop();
+  EXPECT_LE(1000u, v.capacity());
+
+  v.shrink_to_fit();
+  EXPECT_GT(20u, v.capacity());
+  EXPECT_LE(10u, v.capacity());
+  EXPECT_EQ(v[9], xtd::some(9));
+
+  while (!v.empty()) v.pop();
+  v.shrink_to_fit();
+  EXPECT_EQ(7u, v.capacity());
+  EXPECT_EQ(0u, v.stats().directory_bytes);
+  v.push(42);
+  EXPECT_EQ(v.back(), xtd::some(42));
+}
+
+TEST(vector, stats) {
+  xtd::vector<int64_t, 1> v;
+  v.retain(xtd::retention::spare_blocks(1));
+  auto stats = v.stats();
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(0u, stats.bytes_in_use);
+  // two inline blocks, of one and two segments
+  EXPECT_EQ(2u, stats.data_blocks);
+  EXPECT_EQ(2u, stats.spare_blocks);
+  EXPECT_EQ(48u, stats.slack_bytes);
+  EXPECT_EQ(48u, stats.inline_bytes);
+
+  for (int64_t i = 0; i < 1000; ++i) v.push(i);
+  stats = v.stats();
+  EXPECT_EQ(1000u, stats.size);
+  EXPECT_EQ(8000u, stats.bytes_in_use);
+  EXPECT_EQ(0u, stats.spare_blocks);
+  EXPECT_EQ(v.capacity() * 8, stats.bytes_in_use + stats.slack_bytes);
+  EXPECT_EQ(stats.bytes_in_use + stats.slack_bytes + stats.directory_bytes,
+            stats.bytes_allocated);
+  EXPECT_LE(stats.data_blocks * sizeof(void*), stats.directory_bytes);
+  // 500 segments, the last of which is in superblock 8
+  EXPECT_EQ(8u, stats.superblock);
+
+  // the slack is O(sqrt(n))
+  EXPECT_GT(4 * 8 * 64u, stats.slack_bytes);
+}
+
+#ifdef XTD_VECTOR_STATS
+TEST(vector, global_stats) {
+  auto const before = xtd::global_stats();
+  {
+    xtd::vector<int64_t> v;
+    for (int64_t i = 0; i < 1000; ++i) v.push(i);
+    auto const during = xtd::global_stats();
+    auto const stats = v.stats();
+    EXPECT_EQ(before.data_blocks + stats.data_blocks - stats.inline_blocks,
+              during.data_blocks);
+    EXPECT_EQ(before.data_block_bytes + v.capacity() * 8 - stats.inline_bytes,
+              during.data_block_bytes);
+    EXPECT_LT(before.allocations, during.allocations);
+  }
+  auto const after = xtd::global_stats();
+  EXPECT_EQ(before.data_blocks, after.data_blocks);
+  EXPECT_EQ(before.data_block_bytes, after.data_block_bytes);
+}
+#endif
+
+namespace {
+// Address space for vectors past 2^32 elements. Only the pages that are
+// written get memory, so the elements are appended without being written.
+class reserved_memory {
+  void* m_data;
+  size_t m_size;
+
+ public:
+  explicit reserved_memory(size_t size)
+      : m_data{::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0)},
+        m_size{size} {}
+
+  reserved_memory(reserved_memory const&) = delete;
+  reserved_memory& operator=(reserved_memory const&) = delete;
+
+  ~reserved_memory() {
+    if (available()) ::munmap(m_data, m_size);
+  }
+
+  bool available() const { return m_data != MAP_FAILED; }
+  void* data() const { return m_data; }
+  size_t size() const { return m_size; }
+};
+
+// Appends `n` chars to `v` without writing them, then checks indexing around
+// every index in `probes` against the iterators.
+template <typename Vector>
+void check_large(Vector& v, size_t n, std::vector<size_t> const& probes) {
+  v.append_runs(n, [](char*, size_t) {});
+  EXPECT_EQ(n, v.size());
+  for (size_t p : probes) {
+    for (size_t i = p - 2; i < p + 2; ++i) {
+      const char value = static_cast<char>('a' + i % 26);
+      v[i].match([value](char& c) { c = value; },
+                 []() { ADD_FAILURE() << "The index is in range."; });
+      EXPECT_EQ(value, v.begin()[i]);
+    }
+  }
+
+  v.push('x');
+  EXPECT_EQ(n + 1, v.size());
+  EXPECT_EQ(v[n], xtd::some('x'));
+  EXPECT_EQ(v.back(), xtd::some('x'));
+  EXPECT_EQ(v.pop(), xtd::some('x'));
+  EXPECT_EQ(n, v.size());
+  EXPECT_EQ(&v.begin()[n - 1], &*std::prev(v.end()));
+}
+}
+
+// 2^32 + 2^20 elements of 4 KiB segments: fewer than 2^32 segments, so the
+// compact counters hold them, but the element indices need 64 bits.
+TEST(vector, elements_past_2_32) {
+  reserved_memory memory{(size_t{1} << 33)};
+  if (!memory.available()) GTEST_SKIP() << "Not enough address space.";
+  const size_t n = (size_t{1} << 32) + (size_t{1} << 20);
+  // segment 2^20 - 1 is the first of superblock 20
+  const std::vector<size_t> probes{size_t{1} << 32,
+                                   (size_t{1} << 32) - (size_t{1} << 12)};
+  {
+    xtd::monotonic_buffer_resource arena{memory.data(), memory.size()};
+    xtd::vector<char, 12> v{&arena};
+    check_large(v, n, probes);
+  }
+  {
+    xtd::monotonic_buffer_resource arena{memory.data(), memory.size()};
+    xtd::compact_vector<char, 12> v{&arena};
+    check_large(v, n, probes);
+  }
+}
+
+// More than 2^32 segments of one element, across the boundary between
+// superblocks 31 and 32.
+TEST(vector, segments_past_2_32) {
+  reserved_memory memory{(size_t{1} << 33)};
+  if (!memory.available()) GTEST_SKIP() << "Not enough address space.";
+  xtd::monotonic_buffer_resource arena{memory.data(), memory.size()};
+  xtd::vector<char> v{&arena};
+  check_large(v, (size_t{1} << 32) + 5,
+              {(size_t{1} << 32) - 1, (size_t{1} << 31) - 1});
+  EXPECT_EQ(32u, v.stats().superblock);
+}
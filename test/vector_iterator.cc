@@ -2,6 +2,7 @@
 
 #include <string>
 #include <algorithm>
+#include <numeric>
 
 #include <gtest/gtest.h>
 
@@ -85,3 +86,40 @@ TEST(vector_iterator, equality_comparable) {
   EXPECT_NE(i, v.end());
 }
 
+
+TEST(vector_iterator, crosses_blocks) {
+  xtd::vector<int> v;
+  for (int i = 0; i < 1000; ++i) v.push(i);
+
+  int expected{0};
+  for (auto&& i : v) EXPECT_EQ(expected++, i);
+  EXPECT_EQ(1000, expected);
+
+  auto i = v.end();
+  while (i != v.begin()) EXPECT_EQ(--expected, *(--i));
+  EXPECT_EQ(0, expected);
+}
+
+TEST(vector_iterator, random_access) {
+  xtd::vector<int, 2> v;
+  for (int i = 0; i < 1000; ++i) v.push(i);
+
+  auto i = v.begin();
+  EXPECT_EQ(517, i[517]);
+  EXPECT_EQ(0, *i);
+  i += 999;
+  EXPECT_EQ(999, *i);
+  i -= 500;
+  EXPECT_EQ(499, *i);
+  EXPECT_EQ(3, *(i - 496));
+  EXPECT_EQ(v.begin() + 499, i);
+  EXPECT_EQ(1000, v.end() - v.begin());
+  EXPECT_TRUE(v.begin() < i);
+
+  *i = -1;
+  EXPECT_EQ(v[499], xtd::some(-1));
+
+  xtd::vector<int, 2>::const_iterator ci{i};
+  EXPECT_EQ(-1, *ci);
+  EXPECT_EQ(500, ci[1]);
+}
@@ -0,0 +1,58 @@
+#include <xtd/vector.hh>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(vector_span, empty) {
+  xtd::vector<int> v;
+  EXPECT_EQ(v.segments().begin(), v.segments().end());
+  v.for_each_span([](auto) { ADD_FAILURE() << "There are no elements."; });
+}
+
+TEST(vector_span, covers_all_elements) {
+  xtd::vector<int, 1> v;
+  for (int i = 0; i < 1000; ++i) v.push(i);
+
+  std::vector<int> copy;
+  v.for_each_span([&copy](xtd::span<int> s) {
+    EXPECT_FALSE(s.empty());
+    copy.resize(copy.size() + s.size);
+    std::memcpy(copy.data() + copy.size() - s.size, s.data,
+                s.size * sizeof(int));
+  });
+
+  ASSERT_EQ(1000u, copy.size());
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(i, copy[i]);
+}
+
+TEST(vector_span, merges_segments_of_a_block) {
+  xtd::vector<int> v;
+  for (int i = 0; i < 7; ++i) v.push(i);
+
+  // The first three data blocks hold one, two and two segments.
+  std::vector<size_t> sizes;
+  for (auto const& s : v.segments()) sizes.push_back(s.size);
+  EXPECT_EQ((std::vector<size_t>{1, 2, 2, 2}), sizes);
+}
+
+TEST(vector_span, subrange) {
+  xtd::vector<int, 2> v;
+  for (int i = 0; i < 1000; ++i) v.push(i);
+
+  int expected{123};
+  auto const& cv = v;
+  cv.for_each_span(123, 877, [&expected](xtd::span<int const> s) {
+    for (auto i : s) EXPECT_EQ(expected++, i);
+  });
+  EXPECT_EQ(877, expected);
+
+  for (auto const& s : v.segments(990, 2000))
+    for (auto& i : s) i = -i;
+  EXPECT_EQ(v[989], xtd::some(989));
+  EXPECT_EQ(v[990], xtd::some(-990));
+  EXPECT_EQ(v[999], xtd::some(-999));
+
+  EXPECT_EQ(v.segments(10, 10).begin(), v.segments(10, 10).end());
+}
@@ -8,6 +8,8 @@ template <typename T, typename Memory>
 struct array {
   Memory m_data;
 
+  array() = default;
+
   template<typename... Arg>
   explicit array(Arg&&... arg) : m_data{std::forward<Arg>(arg)...} {}
 
@@ -0,0 +1,295 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "optional.hh"
+#include "span.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+// An append-mostly vector of integers, e.g. time series of timestamps or
+// counters, that keeps all but its last segment of 2^N elements frozen in a
+// compact encoding. A full segment is frozen when the next element is
+// pushed, and thawed only when popping below it again, so that pushes and
+// pops around a segment boundary do not re-encode it. A frozen segment keeps
+// its first value, and the differences between consecutive values are zigzag
+// encoded, offset by the smallest of them (frame of reference) and bit-packed
+// in as few bits as most of them need. Regular timestamps thus take a few
+// bits each and a constant series none at all.
+//
+// The segment being appended to stays uncompressed. A read from a frozen
+// segment adds up the deltas before the element, and keeps no state, so that
+// const reads may happen on several threads at a time. for_each_span decodes
+// segment after segment into a buffer of its own and is the fast way to scan
+// the vector.
+template <typename T, uint8_t N = 10>
+class compressed_vector {
+  static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t),
+                "Only integers of up to 64 bits can be compressed.");
+
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+
+  // A frozen segment. The deltas are packed in `width` bits each from
+  // words[0]. The ones that need more bits are exceptions, stored after the
+  // packed deltas as pairs of their index and their value (patched frame of
+  // reference), so that a rare outlier such as a missed sample does not
+  // widen the whole segment.
+  struct frozen {
+    uint64_t first;
+    uint64_t min_delta;
+    std::unique_ptr<uint64_t[]> words;
+    uint32_t exceptions;
+    uint8_t width;
+  };
+
+  std::vector<frozen> m_frozen;
+  std::vector<T> m_tail;
+  std::vector<uint64_t> m_deltas;  // scratch space for freeze()
+  size_t m_frozen_words{0};
+
+  // Integers are encoded as their two's complement bits, so that differences
+  // wrap around the same way for every T.
+  static uint64_t bits_of(T t) { return static_cast<uint64_t>(t); }
+
+  static uint64_t zigzag(uint64_t delta) {
+    return (delta << 1) ^ (0 - (delta >> 63));
+  }
+
+  static uint64_t unzigzag(uint64_t z) { return (z >> 1) ^ (0 - (z & 1)); }
+
+  static uint8_t width_of(uint64_t x) {
+    return x ? static_cast<uint8_t>(superblock::log2(x) + 1) : 0;
+  }
+
+  static uint64_t mask(uint8_t width) {
+    return (width == 64) ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+  }
+
+  // The number of words holding `count` deltas of `width` bits, plus one so
+  // that every delta can be read with a single unaligned load.
+  static size_t packed_words(size_t count, uint8_t width) {
+    return (count * width + 63) / 64 + 1;
+  }
+
+  static size_t words_of(frozen const& f) {
+    if (!f.words) return 0;
+    return packed_words(segmentCapacity() - 1, f.width) + 2 * f.exceptions;
+  }
+
+  // The width that minimizes the bits of the segment, given the number of
+  // deltas of each width.
+  static uint8_t best_width(size_t const (&widths)[65], size_t count) {
+    uint8_t best{64};
+    size_t best_bits = ~size_t{0};
+    size_t exceptions{0};
+    for (int w = 64; w >= 0; --w) {
+      const size_t bits = count * w + exceptions * 128;
+      if (bits <= best_bits) {
+        best = static_cast<uint8_t>(w);
+        best_bits = bits;
+      }
+      exceptions += widths[w];
+    }
+    return best;
+  }
+
+  void freeze() {
+    const size_t count = m_tail.size() - 1;
+    frozen f{bits_of(m_tail[0]), ~uint64_t{0}, nullptr, 0, 0};
+    m_deltas.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      m_deltas[i] = zigzag(bits_of(m_tail[i + 1]) - bits_of(m_tail[i]));
+      if (m_deltas[i] < f.min_delta) f.min_delta = m_deltas[i];
+    }
+    if (!count) f.min_delta = 0;
+
+    size_t widths[65] = {};
+    for (auto& d : m_deltas) ++widths[width_of(d -= f.min_delta)];
+    f.width = best_width(widths, count);
+    for (int w = f.width + 1; w <= 64; ++w)
+      f.exceptions += static_cast<uint32_t>(widths[w]);
+
+    if (f.width || f.exceptions) {
+      const size_t words = packed_words(count, f.width) + 2 * f.exceptions;
+      f.words.reset(new uint64_t[words]());
+      m_frozen_words += words;
+      uint64_t* exceptions = f.words.get() + packed_words(count, f.width);
+      const uint64_t m = mask(f.width);
+      for (size_t i = 0, at = 0; i < count; ++i, at += f.width) {
+        const uint64_t packed = m_deltas[i] & m;
+        const size_t shift = at & 63;
+        f.words[at >> 6] |= packed << shift;
+        if (shift + f.width > 64)
+          f.words[(at >> 6) + 1] |= packed >> (64 - shift);
+        if (m_deltas[i] > m) {
+          *exceptions++ = i;
+          *exceptions++ = m_deltas[i];
+        }
+      }
+    }
+
+    m_frozen.push_back(std::move(f));
+    m_tail.clear();
+  }
+
+  // Decodes frozen segment `s` into `out`.
+  void decode(size_t s, T* out) const {
+    frozen const& f = m_frozen[s];
+    const size_t count = segmentCapacity() - 1;
+    uint64_t value = f.first;
+    out[0] = static_cast<T>(value);
+    if (!count) return;
+    if (!f.words) {
+      for (size_t i = 0; i < count; ++i)
+        out[i + 1] = static_cast<T>(value += unzigzag(f.min_delta));
+      return;
+    }
+
+    auto bytes = reinterpret_cast<unsigned char const*>(f.words.get());
+    uint64_t const* words = f.words.get();
+    const uint8_t width = f.width;
+    const uint64_t m = mask(width);
+    const uint64_t min_delta = f.min_delta;
+    size_t i{0};
+    // decodes the deltas up to index `last`, which are not exceptions; the
+    // locals keep stores to `out` from reloading anything
+    auto run = [&](size_t last) {
+      uint64_t v = value;
+      size_t at = i * width;
+      if (width <= 57) {
+        for (size_t j = i; j < last; ++j, at += width) {
+          // one unaligned load covers the delta wherever it starts in a byte
+          uint64_t packed;
+          std::memcpy(&packed, bytes + (at >> 3), sizeof(packed));
+          v += unzigzag(((packed >> (at & 7)) & m) + min_delta);
+          out[j + 1] = static_cast<T>(v);
+        }
+      } else {
+        for (size_t j = i; j < last; ++j, at += width) {
+          const size_t shift = at & 63;
+          uint64_t packed = words[at >> 6] >> shift;
+          if (shift + width > 64)
+            packed |= words[(at >> 6) + 1] << (64 - shift);
+          v += unzigzag((packed & m) + min_delta);
+          out[j + 1] = static_cast<T>(v);
+        }
+      }
+      value = v;
+      i = last;
+    };
+
+    uint64_t const* exception = words + packed_words(count, width);
+    for (uint32_t e = 0; e < f.exceptions; ++e, exception += 2) {
+      run(exception[0]);
+      value += unzigzag(exception[1] + min_delta);
+      out[++i] = static_cast<T>(value);
+    }
+    run(count);
+  }
+
+  // The element `i` of frozen segment `s`, from the deltas before it.
+  T value_at(size_t s, size_t i) const {
+    frozen const& f = m_frozen[s];
+    if (!f.words) return static_cast<T>(f.first + i * unzigzag(f.min_delta));
+
+    uint64_t const* words = f.words.get();
+    auto bytes = reinterpret_cast<unsigned char const*>(words);
+    uint64_t const* exception =
+        words + packed_words(segmentCapacity() - 1, f.width);
+    uint64_t const* const end = exception + 2 * f.exceptions;
+    const uint64_t m = mask(f.width);
+    uint64_t value = f.first;
+    for (size_t j = 0, at = 0; j < i; ++j, at += f.width) {
+      uint64_t delta;
+      if (exception != end && exception[0] == j) {
+        delta = exception[1];
+        exception += 2;
+      } else if (f.width <= 57) {
+        std::memcpy(&delta, bytes + (at >> 3), sizeof(delta));
+        delta = (delta >> (at & 7)) & m;
+      } else {
+        const size_t shift = at & 63;
+        delta = words[at >> 6] >> shift;
+        if (shift + f.width > 64) delta |= words[(at >> 6) + 1] << (64 - shift);
+        delta &= m;
+      }
+      value += unzigzag(delta + f.min_delta);
+    }
+    return static_cast<T>(value);
+  }
+
+  // Turns the last frozen segment back into the tail.
+  void thaw() {
+    const size_t s = m_frozen.size() - 1;
+    m_tail.resize(segmentCapacity());
+    decode(s, m_tail.data());
+    m_frozen_words -= words_of(m_frozen[s]);
+    m_frozen.pop_back();
+  }
+
+ public:
+  using value_type = T;
+
+  compressed_vector() { m_tail.reserve(segmentCapacity()); }
+
+  compressed_vector& push(T t) {
+    if (m_tail.size() == segmentCapacity()) freeze();
+    m_tail.push_back(t);
+    return *this;
+  }
+
+  optional<T> pop() {
+    if (m_tail.empty() && !m_frozen.empty()) thaw();
+    if (m_tail.empty()) return none{};
+    const T t = m_tail.back();
+    m_tail.pop_back();
+    return some(t);
+  }
+
+  size_t size() const { return (m_frozen.size() << N) + m_tail.size(); }
+
+  bool empty() const { return size() == 0; }
+
+  // The element with index `p`, by value since frozen elements only exist
+  // in decoded copies.
+  optional<T> operator[](size_t p) const {
+    const size_t s = p >> N;
+    const size_t i = p & (segmentCapacity() - 1);
+    if (s < m_frozen.size()) return some(value_at(s, i));
+    if (p < size()) return some(m_tail[i]);
+    return none{};
+  }
+
+  optional<T> back() const { return (*this)[size() - 1]; }
+
+  // The number of segments in the compact encoding.
+  size_t frozen_segments() const { return m_frozen.size(); }
+
+  // The bytes held for the elements: the packed deltas and segment headers,
+  // the uncompressed tail and the scratch space of freeze().
+  size_t bytes_allocated() const {
+    return m_frozen_words * sizeof(uint64_t) +
+           m_frozen.capacity() * sizeof(frozen) +
+           m_tail.capacity() * sizeof(T) +
+           m_deltas.capacity() * sizeof(uint64_t);
+  }
+
+  // Calls `fn` with the elements of each segment, frozen ones decoded into a
+  // buffer that is reused from one segment to the next.
+  template <typename Fn>
+  void for_each_span(Fn&& fn) const {
+    std::vector<T> buffer(m_frozen.empty() ? 0 : segmentCapacity());
+    for (size_t s = 0; s < m_frozen.size(); ++s) {
+      decode(s, buffer.data());
+      fn(span<T const>{buffer.data(), buffer.size()});
+    }
+    if (!m_tail.empty()) fn(span<T const>{m_tail.data(), m_tail.size()});
+  }
+};
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include "array.hh"
+#include "memory_resource.hh"
+#include "optional.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+// A grow-only vector that many threads can push to at once. Elements never
+// move once constructed, so readers can keep indexing into the published
+// prefix [0, size()) while writers append.
+//
+// A push claims its index with a fetch-add, installs any missing data block
+// with a compare-and-swap, constructs the element and marks it as ready. It
+// then advances the published size over every ready element that follows it,
+// so size() only ever covers fully constructed elements and no push waits for
+// another. Element constructors must not throw: a claimed index that never
+// becomes ready would stop the published size from advancing, so push
+// terminates instead.
+template <typename T, uint8_t N = 0>
+class concurrent_vector {
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+
+  using segment_t =
+      array<T,
+            std::aligned_storage_t<sizeof(T), alignof(T)>[segmentCapacity()]>;
+  using block_ptr = std::atomic<segment_t*>;
+  using flag_t = std::atomic<bool>;
+
+  // The data blocks of superblock k are reached through m_directory[k], which
+  // is installed together with the first of them.
+  static constexpr size_t max_superblocks = 64;
+
+  memory_resource* m_resource;
+  std::atomic<block_ptr*> m_directory[max_superblocks];
+  std::atomic<size_t> m_claimed{0};
+  std::atomic<size_t> m_size{0};
+
+  template <typename U>
+  U* allocate(size_t count) {
+    return static_cast<U*>(
+        m_resource->allocate(count * sizeof(U), alignof(U)));
+  }
+
+  template <typename U>
+  void deallocate(U* p, size_t count) {
+    m_resource->deallocate(p, count * sizeof(U), alignof(U));
+  }
+
+  // A data block of `length` segments is followed by one ready flag for each
+  // of its elements.
+  static size_t block_size(size_t length) {
+    return length * (sizeof(segment_t) + segmentCapacity() * sizeof(flag_t));
+  }
+
+  static flag_t& ready_flag(segment_t* b, superblock::location const& loc,
+                            size_t p) {
+    return reinterpret_cast<flag_t*>(b + loc.length)[
+        (loc.segment << N) + (p & (segmentCapacity() - 1))];
+  }
+
+  // Returns the data block `loc` points into, or null if it is not installed.
+  segment_t* find_block(superblock::location const& loc) const {
+    block_ptr* directory =
+        m_directory[loc.superblock].load(std::memory_order_acquire);
+    if (!directory) return nullptr;
+    return directory[loc.block - superblock::first_block(loc.superblock)].load(
+        std::memory_order_acquire);
+  }
+
+  // Returns the data block `loc` points into, installing it if needed.
+  segment_t* block(superblock::location const& loc) {
+    block_ptr* directory =
+        m_directory[loc.superblock].load(std::memory_order_acquire);
+    if (!directory) {
+      const size_t count = superblock::blocks(loc.superblock);
+      block_ptr* fresh = allocate<block_ptr>(count);
+      for (size_t i = 0; i < count; ++i) new (fresh + i) block_ptr{nullptr};
+      if (m_directory[loc.superblock].compare_exchange_strong(
+              directory, fresh, std::memory_order_acq_rel)) {
+        directory = fresh;
+      } else {
+        deallocate(fresh, count);
+      }
+    }
+
+    block_ptr& entry =
+        directory[loc.block - superblock::first_block(loc.superblock)];
+    segment_t* b = entry.load(std::memory_order_acquire);
+    if (!b) {
+      auto fresh = static_cast<segment_t*>(
+          m_resource->allocate(block_size(loc.length), alignof(segment_t)));
+      for (size_t i = 0; i < loc.length; ++i) new (fresh + i) segment_t;
+      flag_t* flags = reinterpret_cast<flag_t*>(fresh + loc.length);
+      for (size_t i = 0; i < (loc.length << N); ++i)
+        new (flags + i) flag_t{false};
+      if (entry.compare_exchange_strong(b, fresh,
+                                        std::memory_order_acq_rel)) {
+        b = fresh;
+      } else {
+        m_resource->deallocate(fresh, block_size(loc.length),
+                               alignof(segment_t));
+      }
+    }
+    return b;
+  }
+
+  T& unsafe_at(size_t p) const {
+    const auto loc = superblock::locate(p >> N);
+    return find_block(loc)[loc.segment][p & (segmentCapacity() - 1)];
+  }
+
+  bool ready(size_t p) const {
+    const auto loc = superblock::locate(p >> N);
+    segment_t* b = find_block(loc);
+    return b && ready_flag(b, loc, p).load();
+  }
+
+  // Moves the published size past the elements that are ready.
+  void publish() {
+    size_t size = m_size.load();
+    while (size < m_claimed.load() && ready(size))
+      if (m_size.compare_exchange_weak(size, size + 1)) ++size;
+  }
+
+ public:
+  concurrent_vector() : concurrent_vector{new_delete_resource()} {}
+
+  // Creates a vector whose data blocks are allocated from `resource`, which
+  // has to be thread-safe and outlive it.
+  explicit concurrent_vector(memory_resource* resource)
+      : m_resource{resource} {
+    for (auto& directory : m_directory) directory.store(nullptr);
+  }
+
+  concurrent_vector(concurrent_vector const&) = delete;
+  concurrent_vector& operator=(concurrent_vector const&) = delete;
+
+  ~concurrent_vector() {
+    for (size_t p = 0, size = m_size.load(); p < size; ++p)
+      unsafe_at(p).~T();
+
+    for (size_t k = 0; k < max_superblocks; ++k) {
+      block_ptr* directory = m_directory[k].load();
+      if (!directory) continue;
+      for (size_t b = 0; b < superblock::blocks(k); ++b)
+        if (segment_t* block = directory[b].load())
+          m_resource->deallocate(block, block_size(superblock::length(k)),
+                                 alignof(segment_t));
+      deallocate(directory, superblock::blocks(k));
+    }
+  }
+
+  // Appends an element constructed from `args` and returns its index. The
+  // element is visible to readers as soon as all the elements before it are.
+  template <typename... Args>
+  size_t push(Args&&... args) noexcept {
+    const size_t p = m_claimed.fetch_add(1, std::memory_order_relaxed);
+    const auto loc = superblock::locate(p >> N);
+    segment_t* b = block(loc);
+    b[loc.segment]
+        .overwrite(p & (segmentCapacity() - 1))
+        .emplace(std::forward<Args>(args)...);
+    ready_flag(b, loc, p).store(true);
+    publish();
+    return p;
+  }
+
+  // The number of published elements.
+  size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+  bool empty() const { return size() == 0; }
+
+  optional<std::reference_wrapper<T>> operator[](size_t p) {
+    if (p < size()) return some(std::ref(unsafe_at(p)));
+    return none{};
+  }
+
+  optional<std::reference_wrapper<T const>> operator[](size_t p) const {
+    if (p < size()) return some(std::cref(unsafe_at(p)));
+    return none{};
+  }
+};
+}
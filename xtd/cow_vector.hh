@@ -0,0 +1,301 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "memory_resource.hh"
+#include "optional.hh"
+#include "span.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+// A vector laid out like xtd::vector whose data blocks are reference counted,
+// so that snapshot() can hand out a consistent, immutable view of it in
+// O(#blocks) without copying any element.
+//
+// A data block is written in place only while the vector holds its only
+// reference, with one exception: push constructs new elements in place past
+// the end of every snapshot, which none of them ever reads. Changing an
+// element through operator[] or popping from a shared block first copies the
+// block. References handed out by operator[] are therefore only valid until
+// the next snapshot().
+//
+// The vector itself is not thread safe, and snapshot() has to be called by
+// its writer. Snapshots can be copied, read and destroyed on any thread, and
+// the memory resource has to outlive all of them.
+template <typename T, uint8_t N = 0>
+class cow_vector {
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+
+  // A data block of `length` elements, the first `constructed` of which are
+  // alive. The header is followed by the elements.
+  struct block {
+    std::atomic<size_t> refs;
+    size_t constructed;  // only written while the vector holds a reference
+    size_t length;
+    memory_resource* resource;
+
+    static constexpr size_t header() {
+      return (sizeof(block) + alignof(T) - 1) & ~(alignof(T) - 1);
+    }
+    static constexpr size_t alignment() {
+      return (alignof(T) > alignof(block)) ? alignof(T) : alignof(block);
+    }
+
+    T* data() {
+      return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + header());
+    }
+  };
+
+  memory_resource* m_resource;
+  std::vector<block*> m_blocks;
+  size_t m_size{0};
+
+  // The data block holding the slot after the last element, as its next slot
+  // and its end. Null when not known yet.
+  block* m_tail{nullptr};
+  T* m_next{nullptr};
+  T* m_end{nullptr};
+
+  static block* allocate(memory_resource* resource, size_t length) {
+    void* p = resource->allocate(block::header() + length * sizeof(T),
+                                 block::alignment());
+    return new (p) block{{1}, 0, length, resource};
+  }
+
+  // Drops a reference to `b`, destroying it along with the last one.
+  static void release(block* b) {
+    if (b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    T* data = b->data();
+    for (size_t i = 0; i < b->constructed; ++i) data[i].~T();
+    memory_resource* resource = b->resource;
+    const size_t bytes = block::header() + b->length * sizeof(T);
+    b->~block();
+    resource->deallocate(b, bytes, block::alignment());
+  }
+
+  // The data block holding index `i` and the offset of `i` in it.
+  static std::pair<size_t, size_t> locate(size_t i) {
+    const auto loc = superblock::locate(i >> N);
+    return {loc.block, (loc.segment << N) + (i & (segmentCapacity() - 1))};
+  }
+
+  // The number of data blocks holding the first `size` elements.
+  static size_t blocks_in(size_t size) {
+    return size ? locate(size - 1).first + 1 : 0;
+  }
+
+  // Calls `fn` with the elements of each of the data blocks in `blocks`,
+  // which hold `size` elements.
+  template <typename U, typename Fn>
+  static void for_each_span(std::vector<block*> const& blocks, size_t size,
+                            Fn&& fn) {
+    for (size_t b = 0; size; ++b) {
+      const size_t count =
+          (size < blocks[b]->length) ? size : blocks[b]->length;
+      fn(span<U>{blocks[b]->data(), count});
+      size -= count;
+    }
+  }
+
+  // Points the tail cursor at the slot of index m_size, allocating its data
+  // block if needed.
+  void seek_tail() {
+    const auto at = locate(m_size);
+    if (at.first == m_blocks.size())
+      m_blocks.push_back(allocate(
+          m_resource, superblock::block_length(at.first) << N));
+    m_tail = m_blocks[at.first];
+    m_next = m_tail->data() + at.second;
+    m_end = m_tail->data() + m_tail->length;
+  }
+
+  // Makes the next push find the tail again.
+  void forget_tail() {
+    m_tail = nullptr;
+    m_next = m_end = nullptr;
+  }
+
+  // Makes data block `b` private to the vector, copying it if a snapshot
+  // shares it.
+  block* own(size_t b) {
+    block* shared = m_blocks[b];
+    if (shared->refs.load(std::memory_order_acquire) == 1) return shared;
+
+    block* copy = allocate(m_resource, shared->length);
+    T* from = shared->data();
+    T* to = copy->data();
+    try {
+      for (; copy->constructed < shared->constructed; ++copy->constructed)
+        new (to + copy->constructed) T(from[copy->constructed]);
+    } catch (...) {
+      release(copy);
+      throw;
+    }
+    if (m_tail == shared) forget_tail();
+    release(shared);
+    return m_blocks[b] = copy;
+  }
+
+  // Moves the last element out, copying its data block first if a snapshot
+  // shares it.
+  T take_last() {
+    const auto at = locate(m_size - 1);
+    block* b = own(at.first);
+    T& last = b->data()[at.second];
+    T result{std::move(last)};
+    last.~T();
+    --b->constructed;
+    --m_size;
+
+    // keep the block that emptied as the spare
+    if (b->constructed == 0 && at.first + 2 == m_blocks.size()) {
+      release(m_blocks.back());
+      m_blocks.pop_back();
+    }
+    forget_tail();
+    return result;
+  }
+
+  template <typename Vector>
+  static auto at(Vector& v, size_t p) {
+    using result_t = optional<std::reference_wrapper<T const>>;
+    if (p >= v.m_size) return result_t{none{}};
+    const auto at = locate(p);
+    return result_t{std::cref(v.m_blocks[at.first]->data()[at.second])};
+  }
+
+ public:
+  using value_type = T;
+
+  // An immutable view of the elements a cow_vector had when it was taken.
+  class snapshot_t {
+    friend class cow_vector;
+
+    std::vector<block*> m_blocks;
+    size_t m_size{0};
+
+    snapshot_t(std::vector<block*> blocks, size_t size)
+        : m_blocks{std::move(blocks)}, m_size{size} {}
+
+   public:
+    using value_type = T;
+
+    snapshot_t() = default;
+
+    snapshot_t(snapshot_t const& other)
+        : m_blocks{other.m_blocks}, m_size{other.m_size} {
+      for (block* b : m_blocks) b->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    snapshot_t(snapshot_t&& other) noexcept
+        : m_blocks{std::move(other.m_blocks)}, m_size{other.m_size} {
+      other.m_blocks.clear();
+      other.m_size = 0;
+    }
+
+    snapshot_t& operator=(snapshot_t other) noexcept {
+      std::swap(m_blocks, other.m_blocks);
+      std::swap(m_size, other.m_size);
+      return *this;
+    }
+
+    ~snapshot_t() {
+      for (block* b : m_blocks) release(b);
+    }
+
+    size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    auto operator[](size_t p) const { return at(*this, p); }
+
+    auto back() const { return at(*this, m_size - 1); }
+
+    // Calls `fn` with the span of every data block.
+    template <typename Fn>
+    void for_each_span(Fn&& fn) const {
+      cow_vector::for_each_span<T const>(m_blocks, m_size,
+                                         std::forward<Fn>(fn));
+    }
+
+    std::vector<span<T const>> segments() const {
+      std::vector<span<T const>> result;
+      for_each_span([&result](span<T const> s) { result.push_back(s); });
+      return result;
+    }
+  };
+
+  cow_vector() : cow_vector{new_delete_resource()} {}
+
+  // Creates a vector whose data blocks are allocated from `resource`, which
+  // has to outlive it and all its snapshots.
+  explicit cow_vector(memory_resource* resource) : m_resource{resource} {}
+
+  cow_vector(cow_vector const&) = delete;
+  cow_vector& operator=(cow_vector const&) = delete;
+
+  ~cow_vector() {
+    for (block* b : m_blocks) release(b);
+  }
+
+  memory_resource* resource() const { return m_resource; }
+
+  // The elements as they are now. Only the directory is copied, and every
+  // data block in use gains a reference.
+  snapshot_t snapshot() const {
+    std::vector<block*> blocks(m_blocks.begin(),
+                               m_blocks.begin() + blocks_in(m_size));
+    for (block* b : blocks) b->refs.fetch_add(1, std::memory_order_relaxed);
+    return snapshot_t{std::move(blocks), m_size};
+  }
+
+  template <typename... Args>
+  cow_vector& push(Args&&... args) {
+    if (m_next == m_end) seek_tail();
+    new (m_next) T(std::forward<Args>(args)...);
+    ++m_next;
+    ++m_tail->constructed;
+    ++m_size;
+    return *this;
+  }
+
+  optional<T> pop() {
+    if (empty()) return none{};
+    return some(take_last());
+  }
+
+  size_t size() const { return m_size; }
+
+  bool empty() const { return m_size == 0; }
+
+  // The element with index `p`, copying its data block first if a snapshot
+  // shares it.
+  optional<std::reference_wrapper<T>> operator[](size_t p) {
+    if (p >= m_size) return none{};
+    const auto at = locate(p);
+    return optional<std::reference_wrapper<T>>{
+        std::ref(own(at.first)->data()[at.second])};
+  }
+
+  auto operator[](size_t p) const { return at(*this, p); }
+
+  auto back() const { return at(*this, m_size - 1); }
+
+  // Calls `fn` with the span of every data block, which may be shared with
+  // snapshots and therefore cannot be changed.
+  template <typename Fn>
+  void for_each_span(Fn&& fn) const {
+    for_each_span<T const>(m_blocks, m_size, std::forward<Fn>(fn));
+  }
+
+  std::vector<span<T const>> segments() const {
+    std::vector<span<T const>> result;
+    for_each_span([&result](span<T const> s) { result.push_back(s); });
+    return result;
+  }
+};
+}
@@ -0,0 +1,285 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memory_resource.hh"
+#include "optional.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+// A double-ended queue whose elements never move. It is made of two sides
+// laid out like xtd::vector, one growing towards the front and one towards
+// the back, so pushing or popping at either end is O(1) and at most a couple
+// of data blocks per side are partly empty. Popping past the end of one side
+// consumes the other side from its far end, and the data blocks it leaves
+// behind are released as soon as they empty.
+//
+// Block sizes follow the indices on each side. A queue that is pushed at one
+// end and popped at the other keeps indexing further into larger blocks, so
+// once more indices of a side have been popped than are live, its new
+// elements start over from index 0 in a second run of blocks. Memory thus
+// stays proportional to the number of elements held rather than to the
+// number that went through the queue.
+template <typename T, uint8_t N = 0>
+class deque {
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+
+  // A run of elements with indices in [first, last). Data block b holds the
+  // elements with indices from superblock::segments_in(b) << N on, and is
+  // null until it is needed or once it has been released.
+  class run {
+    memory_resource* m_resource;
+    std::vector<T*> m_blocks;
+    size_t m_first{0};
+    size_t m_last{0};
+
+    // The data block holding the slot of index m_last, as [m_begin, m_end),
+    // with m_next pointing to that slot. Null when not known yet.
+    size_t m_tail_block{0};
+    T* m_begin{nullptr};
+    T* m_next{nullptr};
+    T* m_end{nullptr};
+
+    // The element with index m_first and the end of its data block, when
+    // known.
+    size_t m_head_block{0};
+    T* m_head{nullptr};
+    T* m_head_end{nullptr};
+
+    static size_t block_size(size_t b) {
+      return (superblock::block_length(b) << N) * sizeof(T);
+    }
+
+    void release(size_t b) {
+      if (b < m_blocks.size() && m_blocks[b]) {
+        m_resource->deallocate(m_blocks[b], block_size(b), alignof(T));
+        m_blocks[b] = nullptr;
+      }
+    }
+
+    // The block holding index `i` and the offset of `i` in it.
+    static superblock::location locate(size_t i) {
+      auto loc = superblock::locate(i >> N);
+      loc.segment = (loc.segment << N) + (i & (segmentCapacity() - 1));
+      loc.length <<= N;
+      return loc;
+    }
+
+    // Points the tail cursor at the slot of index m_last, allocating its data
+    // block if needed.
+    void seek_tail() {
+      const auto at = locate(m_last);
+      if (at.block == m_blocks.size()) m_blocks.push_back(nullptr);
+      T*& block = m_blocks[at.block];
+      if (!block)
+        block = static_cast<T*>(
+            m_resource->allocate(block_size(at.block), alignof(T)));
+      m_tail_block = at.block;
+      m_begin = block;
+      m_next = block + at.segment;
+      m_end = block + at.length;
+    }
+
+    // Restarts the indices from 0 once the run is empty, keeping the first
+    // data block.
+    void reset() {
+      for (size_t b = 1; b < m_blocks.size(); ++b) release(b);
+      m_blocks.resize(m_blocks.empty() ? 0 : 1);
+      m_first = m_last = 0;
+      m_begin = m_next = m_end = m_head = m_head_end = nullptr;
+    }
+
+    static T take(T& t) {
+      T result(std::move(t));
+      t.~T();
+      return result;
+    }
+
+   public:
+    explicit run(memory_resource* resource) : m_resource{resource} {}
+
+    run(run const&) = delete;
+    run& operator=(run const&) = delete;
+
+    ~run() {
+      for (size_t i = 0; i < size(); ++i) (*this)[i].~T();
+      for (size_t b = 0; b < m_blocks.size(); ++b) release(b);
+    }
+
+    size_t size() const { return m_last - m_first; }
+
+    // The number of elements popped from the first end since the run was
+    // last empty.
+    size_t popped() const { return m_first; }
+
+    // The element with index `i`, counting from the first live one.
+    T& operator[](size_t i) const {
+      const auto at = locate(m_first + i);
+      return m_blocks[at.block][at.segment];
+    }
+
+    template <typename... Args>
+    void push_last(Args&&... args) {
+      if (m_next == m_end) seek_tail();
+      new (m_next) T(std::forward<Args>(args)...);
+      ++m_next;
+      ++m_last;
+    }
+
+    // Expects a non-empty run.
+    T pop_last() {
+      if (m_next == m_begin) {
+        // point the cursor right after the last element
+        --m_last;
+        seek_tail();
+        ++m_last;
+        ++m_next;
+      }
+      T result = take(*--m_next);
+      --m_last;
+      if (m_first == m_last) {
+        reset();
+      } else if (m_next == m_begin) {
+        // keep the block that emptied as the spare
+        release(m_tail_block + 1);
+      }
+      return result;
+    }
+
+    // Expects a non-empty run.
+    T pop_first() {
+      if (!m_head) {
+        const auto at = locate(m_first);
+        m_head_block = at.block;
+        m_head = m_blocks[at.block] + at.segment;
+        m_head_end = m_blocks[at.block] + at.length;
+      }
+      T result = take(*m_head++);
+      ++m_first;
+      if (m_first == m_last) {
+        reset();
+      } else if (m_head == m_head_end) {
+        // the tail cursor may still be at the end of the released block
+        if (m_tail_block == m_head_block) m_begin = m_next = m_end = nullptr;
+        release(m_head_block);
+        m_head = nullptr;
+      }
+      return result;
+    }
+  };
+
+  // One end of the deque: the older run, followed while it drains by the
+  // newer one, which takes the pushes once the older run has popped more
+  // elements than it holds.
+  class side {
+    run m_a;
+    run m_b;
+    run* m_older{&m_a};
+    run* m_newer{&m_b};
+
+   public:
+    explicit side(memory_resource* resource)
+        : m_a{resource}, m_b{resource} {}
+
+    side(side const&) = delete;
+    side& operator=(side const&) = delete;
+
+    size_t size() const { return m_older->size() + m_newer->size(); }
+
+    T& operator[](size_t i) const {
+      const size_t older = m_older->size();
+      return (i < older) ? (*m_older)[i] : (*m_newer)[i - older];
+    }
+
+    template <typename... Args>
+    void push_last(Args&&... args) {
+      const bool restart =
+          m_newer->size() || m_older->popped() > m_older->size();
+      (restart ? m_newer : m_older)->push_last(std::forward<Args>(args)...);
+    }
+
+    // Expects a non-empty side.
+    T pop_last() {
+      return (m_newer->size() ? m_newer : m_older)->pop_last();
+    }
+
+    // Expects a non-empty side.
+    T pop_first() {
+      T result = m_older->pop_first();
+      if (!m_older->size()) std::swap(m_older, m_newer);
+      return result;
+    }
+  };
+
+  // The front side holds the first elements in reverse order.
+  side m_front;
+  side m_back;
+
+  template <typename Deque>
+  static auto at(Deque& d, size_t p) {
+    using value_t =
+        std::conditional_t<std::is_const<Deque>::value, T const, T>;
+    using result_t = optional<std::reference_wrapper<value_t>>;
+    const size_t front = d.m_front.size();
+    if (p < front)
+      return result_t{std::ref<value_t>(d.m_front[front - 1 - p])};
+    if (p - front < d.m_back.size())
+      return result_t{std::ref<value_t>(d.m_back[p - front])};
+    return result_t{none{}};
+  }
+
+ public:
+  using value_type = T;
+
+  deque() : deque{new_delete_resource()} {}
+
+  // Creates a deque whose data blocks are allocated from `resource`, which
+  // has to outlive it.
+  explicit deque(memory_resource* resource)
+      : m_front{resource}, m_back{resource} {}
+
+  template <typename... Args>
+  deque& push_back(Args&&... args) {
+    m_back.push_last(std::forward<Args>(args)...);
+    return *this;
+  }
+
+  template <typename... Args>
+  deque& push_front(Args&&... args) {
+    m_front.push_last(std::forward<Args>(args)...);
+    return *this;
+  }
+
+  optional<T> pop_back() {
+    if (m_back.size()) return some(m_back.pop_last());
+    if (m_front.size()) return some(m_front.pop_first());
+    return none{};
+  }
+
+  optional<T> pop_front() {
+    if (m_front.size()) return some(m_front.pop_last());
+    if (m_back.size()) return some(m_back.pop_first());
+    return none{};
+  }
+
+  auto operator[](size_t p) { return at(*this, p); }
+
+  auto operator[](size_t p) const { return at(*this, p); }
+
+  auto front() { return at(*this, 0); }
+
+  auto front() const { return at(*this, 0); }
+
+  auto back() { return at(*this, size() - 1); }
+
+  auto back() const { return at(*this, size() - 1); }
+
+  size_t size() const { return m_front.size() + m_back.size(); }
+
+  bool empty() const { return size() == 0; }
+};
+}
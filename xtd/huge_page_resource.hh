@@ -0,0 +1,160 @@
+#pragma once
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "memory_resource.hh"
+
+namespace xtd {
+
+// Serves the data blocks of a container from memory aligned to 2 MiB and
+// advised for transparent huge pages, so that random access over a large
+// vector needs a TLB entry per 2 MiB instead of per 4 KiB page.
+//
+// Allocations of at least `threshold` bytes are rounded up to a power of two
+// and cut out of shared 2 MiB chunks, one size per chunk, so that the many
+// blocks of a vector smaller than a huge page still end up on huge pages.
+// Freed blocks are kept for the next allocation of their size and the chunks
+// are only unmapped with the resource. Allocations larger than half a chunk
+// are mapped on their own, rounded up to a multiple of 2 MiB. Smaller
+// allocations come from an upstream resource, aligned to at least a cache
+// line so that every span can be loaded with aligned vector instructions.
+//
+// Whether huge pages are actually used is up to the kernel (see
+// /sys/kernel/mm/transparent_hugepage/enabled); the alignment holds either
+// way. Like monotonic_buffer_resource, it is not thread safe.
+class huge_page_resource : public memory_resource {
+ public:
+  static constexpr size_t huge_page_size = size_t{2} << 20;
+  static constexpr size_t cache_line_size = 64;
+
+ private:
+  // The sizes cut out of chunks, as powers of two from a cache line to half
+  // a chunk.
+  static constexpr size_t min_class = 6;
+  static constexpr size_t max_class = 20;
+
+  struct size_class {
+    void* free{nullptr};  // freed blocks, each pointing to the next
+    char* next{nullptr};  // the part of the last chunk not handed out yet
+    char* end{nullptr};
+  };
+
+  memory_resource* m_upstream;
+  size_t m_threshold;
+  size_class m_classes[max_class - min_class + 1];
+  std::vector<void*> m_chunks;
+  size_t m_mapped_bytes{0};
+
+  static size_t round_up(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) & ~(alignment - 1);
+  }
+
+  // The size class of a chunked allocation, or 0 for one mapped on its own.
+  static size_t class_of(size_t bytes, size_t alignment) {
+    if (bytes < alignment) bytes = alignment;
+    if (bytes > (size_t{1} << max_class)) return 0;
+    size_t c{min_class};
+    while ((size_t{1} << c) < bytes) ++c;
+    return c;
+  }
+
+  static size_t small_alignment(size_t alignment) {
+    if (alignment < cache_line_size) alignment = cache_line_size;
+    return alignment;
+  }
+
+  static size_t huge_alignment(size_t alignment) {
+    if (alignment < huge_page_size) alignment = huge_page_size;
+    return alignment;
+  }
+
+  // Maps `length` bytes aligned to `alignment`, advised for huge pages.
+  void* map(size_t length, size_t alignment) {
+    // map enough to find an aligned range and unmap what is left around it
+    const size_t extra = length + alignment;
+    void* raw = ::mmap(nullptr, extra, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) throw std::bad_alloc{};
+
+    const auto first = reinterpret_cast<uintptr_t>(raw);
+    const auto aligned = round_up(first, alignment);
+    if (aligned != first) ::munmap(raw, aligned - first);
+    if (const size_t tail = first + extra - (aligned + length))
+      ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+
+    void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    ::madvise(p, length, MADV_HUGEPAGE);
+#endif
+    m_mapped_bytes += length;
+    return p;
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    if (bytes < m_threshold)
+      return m_upstream->allocate(bytes, small_alignment(alignment));
+
+    const size_t c = class_of(bytes, alignment);
+    if (!c)
+      return map(round_up(bytes, huge_page_size), huge_alignment(alignment));
+
+    size_class& sc = m_classes[c - min_class];
+    if (void* p = sc.free) {
+      sc.free = *static_cast<void**>(p);
+      return p;
+    }
+    if (sc.next == sc.end) {
+      // room for the chunk first, so that push_back cannot throw and leak it
+      if (m_chunks.size() == m_chunks.capacity())
+        m_chunks.reserve(2 * m_chunks.size() + 1);
+      sc.next = static_cast<char*>(map(huge_page_size, huge_page_size));
+      sc.end = sc.next + huge_page_size;
+      m_chunks.push_back(sc.next);
+    }
+    void* p = sc.next;
+    sc.next += size_t{1} << c;
+    return p;
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    if (bytes < m_threshold)
+      return m_upstream->deallocate(p, bytes, small_alignment(alignment));
+
+    const size_t c = class_of(bytes, alignment);
+    if (!c) {
+      ::munmap(p, round_up(bytes, huge_page_size));
+      m_mapped_bytes -= round_up(bytes, huge_page_size);
+      return;
+    }
+    size_class& sc = m_classes[c - min_class];
+    *static_cast<void**>(p) = sc.free;
+    sc.free = p;
+  }
+
+ public:
+  // Serves the allocations of at least `threshold` bytes from huge pages and
+  // takes the others from `upstream`, which has to outlive this resource.
+  explicit huge_page_resource(
+      size_t threshold = size_t{4} << 10,
+      memory_resource* upstream = new_delete_resource())
+      : m_upstream{upstream}, m_threshold{threshold ? threshold : 1} {}
+
+  huge_page_resource(huge_page_resource const&) = delete;
+  huge_page_resource& operator=(huge_page_resource const&) = delete;
+
+  ~huge_page_resource() {
+    for (void* chunk : m_chunks) ::munmap(chunk, huge_page_size);
+  }
+
+  size_t threshold() const { return m_threshold; }
+
+  memory_resource* upstream_resource() const { return m_upstream; }
+
+  // The bytes currently mapped for huge pages, in chunks or on their own.
+  size_t mapped_bytes() const { return m_mapped_bytes; }
+};
+}
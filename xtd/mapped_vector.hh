@@ -0,0 +1,267 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "optional.hh"
+#include "span.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+enum class mapped_sync {
+  none,     // leave writing back dirty pages to the kernel
+  on_close  // msync every mapping before closing the file
+};
+
+// A vector of trivially copyable elements whose data blocks live in a memory
+// mapped file. Blocks are laid out in the file one after the other, in the
+// same superblock order as xtd::vector, after a header holding the element
+// count. The layout only depends on the number of elements, so reopening a
+// file maps its blocks back in O(blocks) without reading or copying the data.
+// Growing into a new block extends the file and maps the new block.
+template <typename T, uint8_t N = 0>
+class mapped_vector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "mapped_vector stores its elements in a file as raw bytes.");
+
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+  static constexpr uint64_t magic = 0x31766d6474787fULL;  // "\x7fxtdmv1"
+
+  struct header {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t element_alignment;
+    uint64_t segment_bits;
+    uint64_t data_offset;  // where the first data block starts in the file
+    uint64_t blocks;       // the number of data blocks in the file
+    uint64_t size;         // the number of elements
+  };
+
+  struct mapping {
+    void* base;
+    size_t length;
+    T* data;
+  };
+
+  int m_fd{-1};
+  mapped_sync m_sync{mapped_sync::none};
+  header* m_header{nullptr};
+  size_t m_header_length{0};
+  std::vector<mapping> m_blocks;
+
+  // The unused part of the data block holding the next element, when known.
+  T* m_next{nullptr};
+  size_t m_room{0};
+
+  static size_t page_size() {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  // The most data blocks a file can hold: those of the superblocks whose
+  // elements can all be indexed with a size_t.
+  static constexpr size_t maxBlocks() {
+    return superblock::first_block(8 * sizeof(size_t) - N);
+  }
+
+  // Whether the `blocks` data blocks of header `hd` fit in a file of
+  // `file_size` bytes. Checks `blocks` before any arithmetic with it and
+  // divides rather than multiplies, so a corrupt header cannot wrap around.
+  static bool fits(header const& hd, size_t file_size) {
+    const size_t unit = segmentCapacity() * sizeof(T);
+    return hd.blocks <= maxBlocks() && hd.data_offset <= file_size &&
+           superblock::segments_in(hd.blocks) <=
+               (file_size - hd.data_offset) / unit;
+  }
+
+  size_t block_offset(size_t b) const {
+    return m_header->data_offset + superblock::segments_in(b) *
+                                       segmentCapacity() * sizeof(T);
+  }
+
+  // Maps data block `b`, which has to lie within the file.
+  bool map_block(size_t b) {
+    const size_t offset = block_offset(b);
+    const size_t delta = offset % page_size();
+    const size_t length =
+        delta + superblock::block_length(b) * segmentCapacity() * sizeof(T);
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      m_fd, offset - delta);
+    if (base == MAP_FAILED) return false;
+    m_blocks.push_back(
+        {base, length, reinterpret_cast<T*>(static_cast<char*>(base) + delta)});
+    return true;
+  }
+
+  // Extends the file by one data block and maps it.
+  bool grow() {
+    const size_t b = m_blocks.size();
+    const size_t end = block_offset(b) + superblock::block_length(b) *
+                                             segmentCapacity() * sizeof(T);
+    if (ftruncate(m_fd, end) != 0 || !map_block(b)) return false;
+    m_header->blocks = b + 1;
+    return true;
+  }
+
+  T& unsafe_at(size_t p) const {
+    const auto loc = superblock::locate(p >> N);
+    return m_blocks[loc.block]
+        .data[(loc.segment << N) + (p & (segmentCapacity() - 1))];
+  }
+
+  void close() {
+    if (m_header && m_sync == mapped_sync::on_close) flush();
+    for (auto const& b : m_blocks) munmap(b.base, b.length);
+    m_blocks.clear();
+    if (m_header) munmap(m_header, m_header_length);
+    if (m_fd >= 0) ::close(m_fd);
+    m_header = nullptr;
+    m_fd = -1;
+  }
+
+  mapped_vector() = default;
+
+ public:
+  using value_type = T;
+
+  // Opens the vector stored in the file at `path`, creating an empty one if
+  // the file does not exist. Returns none if the file cannot be mapped or
+  // holds a vector of a different element type or segment size.
+  static optional<mapped_vector> open(char const* path,
+                                      mapped_sync sync = mapped_sync::none) {
+    mapped_vector v;
+    v.m_sync = sync;
+    v.m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (v.m_fd < 0) return none{};
+
+    struct stat st;
+    if (fstat(v.m_fd, &st) != 0) return none{};
+    const bool fresh = st.st_size == 0;
+    v.m_header_length = page_size();
+    if (fresh && ftruncate(v.m_fd, v.m_header_length) != 0) return none{};
+
+    void* h = mmap(nullptr, v.m_header_length, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, v.m_fd, 0);
+    if (h == MAP_FAILED) return none{};
+    v.m_header = static_cast<header*>(h);
+
+    if (fresh) {
+      *v.m_header = header{magic, sizeof(T), alignof(T), N,
+                           v.m_header_length, 0, 0};
+    } else {
+      header const& hd = *v.m_header;
+      if (static_cast<size_t>(st.st_size) < sizeof(header) ||
+          hd.magic != magic || hd.element_size != sizeof(T) ||
+          hd.element_alignment != alignof(T) || hd.segment_bits != N ||
+          hd.data_offset < sizeof(header) ||
+          hd.data_offset % page_size() != 0 ||
+          !fits(hd, static_cast<size_t>(st.st_size)) ||
+          hd.size > superblock::segments_in(hd.blocks) * segmentCapacity())
+        return none{};
+    }
+
+    v.m_blocks.reserve(v.m_header->blocks);
+    for (size_t b = 0; b < v.m_header->blocks; ++b)
+      if (!v.map_block(b)) return none{};
+    return some(std::move(v));
+  }
+
+  mapped_vector(mapped_vector&& other)
+      : m_fd{other.m_fd},
+        m_sync{other.m_sync},
+        m_header{other.m_header},
+        m_header_length{other.m_header_length},
+        m_blocks{std::move(other.m_blocks)},
+        m_next{other.m_next},
+        m_room{other.m_room} {
+    other.m_fd = -1;
+    other.m_header = nullptr;
+    other.m_blocks.clear();
+  }
+
+  mapped_vector& operator=(mapped_vector&& other) {
+    if (this != &other) {
+      close();
+      std::swap(m_fd, other.m_fd);
+      std::swap(m_sync, other.m_sync);
+      std::swap(m_header, other.m_header);
+      std::swap(m_header_length, other.m_header_length);
+      std::swap(m_blocks, other.m_blocks);
+      m_next = other.m_next;
+      m_room = other.m_room;
+    }
+    return *this;
+  }
+
+  mapped_vector(mapped_vector const&) = delete;
+  mapped_vector& operator=(mapped_vector const&) = delete;
+
+  ~mapped_vector() { close(); }
+
+  // Appends an element, extending the file when the last data block is full.
+  // Returns false if the file could not be extended.
+  template <typename... Args>
+  bool push(Args&&... args) {
+    if (!m_room) {
+      const size_t p = size();
+      const auto loc = superblock::locate(p >> N);
+      if (loc.block == m_blocks.size() && !grow()) return false;
+      const size_t offset = (loc.segment << N) + (p & (segmentCapacity() - 1));
+      m_next = m_blocks[loc.block].data + offset;
+      m_room = (loc.length << N) - offset;
+    }
+    new (m_next++) T(std::forward<Args>(args)...);
+    --m_room;
+    ++m_header->size;
+    return true;
+  }
+
+  optional<T> pop() {
+    if (empty()) return none{};
+    m_room = 0;
+    return some(unsafe_at(--m_header->size));
+  }
+
+  size_t size() const { return m_header->size; }
+
+  bool empty() const { return size() == 0; }
+
+  optional<std::reference_wrapper<T>> operator[](size_t p) {
+    if (p < size()) return some(std::ref(unsafe_at(p)));
+    return none{};
+  }
+
+  optional<std::reference_wrapper<T const>> operator[](size_t p) const {
+    if (p < size()) return some(std::cref(unsafe_at(p)));
+    return none{};
+  }
+
+  // The contiguous runs of elements, one per data block.
+  std::vector<span<T>> segments() const {
+    std::vector<span<T>> result;
+    for (size_t first = 0, b = 0; first < size(); ++b) {
+      const size_t length = superblock::block_length(b) << N;
+      const size_t count = (size() - first < length) ? size() - first : length;
+      result.push_back({m_blocks[b].data, count});
+      first += count;
+    }
+    return result;
+  }
+
+  // Writes the header and all data blocks back to the file.
+  bool flush() const {
+    bool ok = msync(m_header, m_header_length, MS_SYNC) == 0;
+    for (auto const& b : m_blocks)
+      ok = (msync(b.base, b.length, MS_SYNC) == 0) && ok;
+    return ok;
+  }
+};
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace xtd {
+
+// A source of raw memory, modelled after std::pmr::memory_resource.
+class memory_resource {
+ public:
+  virtual ~memory_resource() = default;
+
+  void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    return do_allocate(bytes, alignment);
+  }
+
+  void deallocate(void* p, size_t bytes,
+                  size_t alignment = alignof(std::max_align_t)) {
+    do_deallocate(p, bytes, alignment);
+  }
+
+  bool is_equal(memory_resource const& other) const noexcept {
+    return do_is_equal(other);
+  }
+
+ private:
+  virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+  virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+  virtual bool do_is_equal(memory_resource const& other) const noexcept {
+    return this == &other;
+  }
+};
+
+namespace detail {
+class new_delete_resource_t final : public memory_resource {
+  static constexpr bool over_aligned(size_t alignment) {
+    return alignment > alignof(std::max_align_t);
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    if (!over_aligned(alignment)) return ::operator new(bytes);
+
+    // keep the pointer returned by operator new right before the block
+    void* raw = ::operator new(bytes + alignment + sizeof(void*));
+    const auto first = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+    void** aligned = reinterpret_cast<void**>((first + alignment - 1) &
+                                              ~(uintptr_t{alignment} - 1));
+    aligned[-1] = raw;
+    return aligned;
+  }
+
+  void do_deallocate(void* p, size_t, size_t alignment) override {
+    ::operator delete(over_aligned(alignment) ? static_cast<void**>(p)[-1]
+                                              : p);
+  }
+};
+}
+
+// The resource that allocates with the global operator new.
+inline memory_resource* new_delete_resource() noexcept {
+  static detail::new_delete_resource_t resource;
+  return &resource;
+}
+
+// Hands out memory from chunks of geometrically increasing size taken from an
+// upstream resource. Deallocation is a no-op: the memory is only given back
+// by release() or on destruction, which makes allocation a pointer bump for
+// containers whose lifetime is bounded by the resource, e.g. per request.
+class monotonic_buffer_resource : public memory_resource {
+  struct chunk {
+    chunk* next;
+    size_t size;
+  };
+
+  memory_resource* m_upstream;
+  void* m_buffer;
+  size_t m_buffer_size;
+  size_t m_initial_size;
+  size_t m_next_size;
+
+  chunk* m_chunks{nullptr};
+  void* m_current;
+  size_t m_left;
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    if (void* p = std::align(alignment, bytes, m_current, m_left)) {
+      m_current = static_cast<char*>(m_current) + bytes;
+      m_left -= bytes;
+      return p;
+    }
+
+    const size_t needed = sizeof(chunk) + bytes + alignment;
+    const size_t size = (needed < m_next_size) ? m_next_size : needed;
+    m_chunks = new (m_upstream->allocate(size, alignof(chunk)))
+        chunk{m_chunks, size};
+    m_next_size = size * 2;
+    m_current = m_chunks + 1;
+    m_left = size - sizeof(chunk);
+    return do_allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+ public:
+  explicit monotonic_buffer_resource(
+      size_t initial_size = 1024,
+      memory_resource* upstream = new_delete_resource())
+      : m_upstream{upstream},
+        m_buffer{nullptr},
+        m_buffer_size{0},
+        m_initial_size{initial_size ? initial_size : 1024},
+        m_next_size{m_initial_size},
+        m_current{nullptr},
+        m_left{0} {}
+
+  // Serves allocations from `buffer` until it runs out.
+  monotonic_buffer_resource(void* buffer, size_t size,
+                            memory_resource* upstream = new_delete_resource())
+      : m_upstream{upstream},
+        m_buffer{buffer},
+        m_buffer_size{size},
+        m_initial_size{size ? size : 1024},
+        m_next_size{m_initial_size},
+        m_current{buffer},
+        m_left{size} {}
+
+  monotonic_buffer_resource(monotonic_buffer_resource const&) = delete;
+  monotonic_buffer_resource& operator=(monotonic_buffer_resource const&) =
+      delete;
+
+  ~monotonic_buffer_resource() { release(); }
+
+  // Gives all the chunks back to the upstream resource. Everything allocated
+  // from this resource so far becomes invalid.
+  void release() {
+    while (m_chunks) {
+      chunk* c = m_chunks;
+      m_chunks = c->next;
+      m_upstream->deallocate(c, c->size, alignof(chunk));
+    }
+    m_next_size = m_initial_size;
+    m_current = m_buffer;
+    m_left = m_buffer_size;
+  }
+
+  memory_resource* upstream_resource() const { return m_upstream; }
+};
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <iostream>
 #include <string>
 #include <type_traits>
@@ -45,6 +47,7 @@ class optional {
       static_assert(std::is_same<T&&, decltype(std::move(other.asT()))>::value,
                     "Buba");
       new (&val) T{std::move(other.asT())};
+      other.asT().~T();
     }
     other.some = false;
   }
@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "optional.hh"
+#include "span.hh"
+
+namespace xtd {
+
+namespace detail {
+
+// The number of elements at which a data block is split into several chunks.
+// It does not depend on the number of threads, so neither do the chunks.
+constexpr size_t parallel_grain = size_t{1} << 16;
+
+inline size_t default_concurrency() {
+  const size_t threads = std::thread::hardware_concurrency();
+  return threads ? threads : 1;
+}
+
+template <typename T>
+struct chunk {
+  size_t first;  // the index of the first element in the chunk
+  span<T> elements;
+};
+
+// Splits the elements of `v` into chunks that never straddle a data block.
+template <typename Vector>
+auto chunks(Vector& v) {
+  using T = std::remove_reference_t<decltype(*v.begin())>;
+  std::vector<chunk<T>> result;
+  size_t first{0};
+  for (auto const& s : v.segments()) {
+    for (size_t offset = 0; offset < s.size; offset += parallel_grain) {
+      const size_t size = std::min(parallel_grain, s.size - offset);
+      result.push_back({first + offset, {s.data + offset, size}});
+    }
+    first += s.size;
+  }
+  return result;
+}
+
+// Runs `task(i, chunks[i])` for every chunk on up to `threads` threads,
+// including the calling one.
+template <typename Chunks, typename Task>
+void run(Chunks const& chunks, size_t threads, Task&& task) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < chunks.size(); i = next++) task(i, chunks[i]);
+  };
+
+  threads = std::min(threads ? threads : 1, chunks.size());
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) workers.emplace_back(worker);
+  worker();
+  for (auto& w : workers) w.join();
+}
+}
+
+// Calls `fn` on every element of `v`, spreading the data blocks over up to
+// `threads` threads.
+template <typename Vector, typename Fn>
+void parallel_for_each(Vector& v, Fn fn,
+                       size_t threads = detail::default_concurrency()) {
+  detail::run(detail::chunks(v), threads, [&fn](size_t, auto const& c) {
+    for (auto& e : c.elements) fn(e);
+  });
+}
+
+// Assigns `fn(src[i])` to `dst[i]` for every index that is valid in both.
+template <typename Source, typename Destination, typename Fn>
+void parallel_transform(Source const& src, Destination& dst, Fn fn,
+                        size_t threads = detail::default_concurrency()) {
+  const size_t size = std::min(src.size(), dst.size());
+  detail::run(detail::chunks(src), threads, [&](size_t, auto const& c) {
+    if (c.first >= size) return;
+    auto out = dst.begin() + c.first;
+    const size_t count = std::min(c.elements.size, size - c.first);
+    for (size_t i = 0; i < count; ++i, ++out) *out = fn(c.elements.data[i]);
+  });
+}
+
+// Folds the elements of `v` into `init` with `op`. Every chunk is folded on
+// its own and the partial results are then combined in order, so the result
+// is the same for any number of threads as long as `op` is associative.
+template <typename Vector, typename U, typename Op>
+U parallel_reduce(Vector const& v, U init, Op op,
+                  size_t threads = detail::default_concurrency()) {
+  const auto chunks = detail::chunks(v);
+  std::vector<optional<U>> partial(chunks.size());
+  detail::run(chunks, threads, [&](size_t i, auto const& c) {
+    U acc(c.elements.data[0]);
+    for (size_t j = 1; j < c.elements.size; ++j)
+      acc = op(std::move(acc), c.elements.data[j]);
+    partial[i] = some(std::move(acc));
+  });
+
+  for (auto& p : partial)
+    p.match([&](U& u) { init = op(std::move(init), std::move(u)); }, []() {});
+  return init;
+}
+
+// Counts the elements of `v` for which `pred` holds.
+template <typename Vector, typename Pred>
+size_t parallel_count_if(Vector const& v, Pred pred,
+                         size_t threads = detail::default_concurrency()) {
+  const auto chunks = detail::chunks(v);
+  std::vector<size_t> partial(chunks.size());
+  detail::run(chunks, threads, [&](size_t i, auto const& c) {
+    size_t count{0};
+    for (auto const& e : c.elements) count += pred(e) ? 1 : 0;
+    partial[i] = count;
+  });
+
+  size_t count{0};
+  for (auto p : partial) count += p;
+  return count;
+}
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "vector.hh"
+
+namespace xtd {
+
+// The binary format written by write_to and read by read_from: a header
+// followed by the raw bytes of the elements in order. The element bytes do
+// not depend on the segment size, so a vector may be read back with a
+// different N than it was written with.
+struct serialization_header {
+  static constexpr uint64_t magic_value = 0x31767364747880ULL;  // "\x80xtdsv1"
+
+  uint64_t magic;
+  uint64_t element_size;
+  uint64_t size;         // the number of elements
+  uint8_t segment_bits;  // the N of the vector that was written
+  uint8_t has_checksum;
+  uint8_t reserved[6];
+  uint64_t checksum;
+};
+
+enum class checksum_mode { none, verify };
+
+// A 64-bit checksum of a stream of bytes that does not depend on how the
+// stream is split into runs.
+class stream_checksum {
+  uint64_t m_hash{0x9e3779b97f4a7c15ULL};
+  uint64_t m_word{0};
+  size_t m_pending{0};  // bytes of m_word that are filled
+  uint64_t m_total{0};
+
+  void mix(uint64_t word) {
+    m_hash ^= word * 0x87c37b91114253d5ULL;
+    m_hash = ((m_hash << 31) | (m_hash >> 33)) * 0x4cf5ad432745937fULL;
+  }
+
+ public:
+  void update(void const* data, size_t n) {
+    auto p = static_cast<unsigned char const*>(data);
+    m_total += n;
+    for (; n && m_pending; --n, ++p) {
+      m_word |= uint64_t{*p} << (8 * m_pending);
+      if (++m_pending == 8) mix(m_word), m_word = 0, m_pending = 0;
+    }
+    for (; n >= 8; n -= 8, p += 8) {
+      uint64_t word;
+      std::memcpy(&word, p, 8);
+      mix(word);
+    }
+    for (; n; --n, ++p) m_word |= uint64_t{*p} << (8 * m_pending++);
+  }
+
+  uint64_t value() const {
+    stream_checksum last{*this};
+    last.mix(m_word);
+    last.mix(m_total);
+    return last.m_hash;
+  }
+};
+
+namespace detail {
+
+// Calls `io(fd, iov, count)` (writev or readv) until all the buffers in `iov`
+// are transferred, at most IOV_MAX at a time. Returns false on an error or if
+// the stream ends early.
+template <typename Io>
+bool transfer_all(Io io, int fd, std::vector<iovec>& iov) {
+  size_t first{0};
+  while (first < iov.size()) {
+    const size_t count = std::min<size_t>(iov.size() - first, IOV_MAX);
+    const ssize_t done = io(fd, iov.data() + first, count);
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) return false;
+
+    // skip the buffers that were transferred whole and trim a partial one
+    size_t left = static_cast<size_t>(done);
+    for (; first < iov.size() && left >= iov[first].iov_len; ++first)
+      left -= iov[first].iov_len;
+    if (left) {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+      iov[first].iov_len -= left;
+    }
+  }
+  return true;
+}
+
+// The number of elements read_from allocates and reads at a time, so that a
+// bogus size in a stream it cannot measure fails after at most 16 MiB.
+template <typename T>
+constexpr size_t read_batch() {
+  return (sizeof(T) < (size_t{1} << 24)) ? (size_t{1} << 24) / sizeof(T) : 1;
+}
+
+// Whether `fd` is a regular file with fewer than `bytes` bytes left to read.
+inline bool shorter_than(int fd, uint64_t bytes) {
+  struct stat st;
+  const off_t at = ::lseek(fd, 0, SEEK_CUR);
+  return at >= 0 && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+         st.st_size >= at && bytes > uint64_t(st.st_size - at);
+}
+}
+
+// Writes the elements of `v` to `fd` with one writev per IOV_MAX data blocks,
+// straight from the blocks and without copying. Returns false if the write
+// failed, in which case part of the stream may have been written.
+template <typename T, uint8_t N, typename Size>
+bool write_to(int fd, vector<T, N, Size> const& v,
+              checksum_mode checksum = checksum_mode::none) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable elements can be written as bytes.");
+  serialization_header header{serialization_header::magic_value,
+                              sizeof(T),
+                              v.size(),
+                              N,
+                              checksum == checksum_mode::verify,
+                              {},
+                              0};
+
+  std::vector<iovec> iov{{&header, sizeof(header)}};
+  stream_checksum sum;
+  v.for_each_span([&](span<T const> s) {
+    iov.push_back({const_cast<T*>(s.data), s.size * sizeof(T)});
+    if (checksum == checksum_mode::verify)
+      sum.update(s.data, iov.back().iov_len);
+  });
+  header.checksum = sum.value();
+  return detail::transfer_all(::writev, fd, iov);
+}
+
+// Appends the elements written to `fd` by write_to to `v`, reading straight
+// into its data blocks with readv. The size in the stream is checked against
+// the length of a regular file, and other streams are allocated for and read
+// a batch at a time, so that a corrupt size cannot allocate much more than
+// the stream holds. Returns false if the stream is not a vector of T, ends
+// early or fails its checksum, in which case `v` is left as it was.
+template <typename T, uint8_t N, typename Size>
+bool read_from(int fd, vector<T, N, Size>& v) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable elements can be read as bytes.");
+  serialization_header header;
+  std::vector<iovec> iov{{&header, sizeof(header)}};
+  if (!detail::transfer_all(::readv, fd, iov) ||
+      header.magic != serialization_header::magic_value ||
+      header.element_size != sizeof(T) ||
+      header.size > UINT64_MAX / sizeof(T) ||
+      detail::shorter_than(fd, header.size * sizeof(T)))
+    return false;
+
+  const size_t old_size = v.size();
+  bool ok{true};
+  for (uint64_t left = header.size; ok && left;) {
+    const size_t batch =
+        (left < detail::read_batch<T>()) ? left : detail::read_batch<T>();
+    iov.clear();
+    v.append_runs(batch, [&iov](T* dst, size_t count) {
+      iov.push_back({dst, count * sizeof(T)});
+    });
+    ok = detail::transfer_all(::readv, fd, iov);
+    left -= batch;
+  }
+  if (ok && header.has_checksum) {
+    stream_checksum sum;
+    v.for_each_span(old_size, v.size(), [&sum](span<T> s) {
+      sum.update(s.data, s.size * sizeof(T));
+    });
+    ok = sum.value() == header.checksum;
+  }
+  if (!ok) v.truncate(old_size);
+  return ok;
+}
+}
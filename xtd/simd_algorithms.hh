@@ -0,0 +1,308 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "optional.hh"
+#include "span.hh"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XTD_SIMD_X86 1
+#else
+#define XTD_SIMD_X86 0
+#endif
+
+namespace xtd {
+
+// Reductions and searches over the elements of an xtd::vector of arithmetic
+// type. They run over whole data blocks at a time with kernels written so the
+// compiler can vectorize them, compiled once for the baseline ISA and, on x86,
+// once more for AVX2, which is picked at runtime when the CPU supports it.
+//
+// sum and minmax use several independent accumulators, so for floating point
+// elements they may round differently than a sequential loop and minmax does
+// not order NaNs.
+namespace simd {
+
+template <typename T>
+using sum_t = std::conditional_t<
+    std::is_floating_point<T>::value, T,
+    std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+
+namespace detail {
+
+// The number of elements handled per step, enough for the compiler to keep
+// several vector registers busy.
+template <typename T>
+constexpr size_t lanes() {
+  return (32 / sizeof(T) > 8) ? 32 / sizeof(T) : 8;
+}
+
+#define XTD_SIMD_KERNEL inline __attribute__((always_inline))
+
+template <typename T>
+XTD_SIMD_KERNEL sum_t<T> sum(T const* p, size_t n) {
+  constexpr size_t L = lanes<T>();
+  sum_t<T> acc[L] = {};
+  size_t i{0};
+  for (; i + L <= n; i += L)
+    for (size_t j = 0; j < L; ++j) acc[j] += p[i + j];
+
+  sum_t<T> total{};
+  for (size_t j = 0; j < L; ++j) total += acc[j];
+  for (; i < n; ++i) total += p[i];
+  return total;
+}
+
+// Expects n > 0.
+template <typename T>
+XTD_SIMD_KERNEL std::pair<T, T> minmax(T const* p, size_t n) {
+  constexpr size_t L = lanes<T>();
+  T lo[L];
+  T hi[L];
+  for (size_t j = 0; j < L; ++j) lo[j] = hi[j] = p[0];
+
+  size_t i{0};
+  for (; i + L <= n; i += L)
+    for (size_t j = 0; j < L; ++j) {
+      lo[j] = (p[i + j] < lo[j]) ? p[i + j] : lo[j];
+      hi[j] = (hi[j] < p[i + j]) ? p[i + j] : hi[j];
+    }
+  for (; i < n; ++i) {
+    lo[0] = (p[i] < lo[0]) ? p[i] : lo[0];
+    hi[0] = (hi[0] < p[i]) ? p[i] : hi[0];
+  }
+
+  for (size_t j = 1; j < L; ++j) {
+    lo[0] = (lo[j] < lo[0]) ? lo[j] : lo[0];
+    hi[0] = (hi[0] < hi[j]) ? hi[j] : hi[0];
+  }
+  return {lo[0], hi[0]};
+}
+
+// Returns the index of the first element equal to `value`, or n.
+template <typename T>
+XTD_SIMD_KERNEL size_t find(T const* p, size_t n, T value) {
+  constexpr size_t L = lanes<T>();
+  size_t i{0};
+  for (; i + L <= n; i += L) {
+    bool any{false};
+    for (size_t j = 0; j < L; ++j) any |= (p[i + j] == value);
+    if (any) break;
+  }
+  for (; i < n; ++i)
+    if (p[i] == value) return i;
+  return n;
+}
+
+template <typename T>
+XTD_SIMD_KERNEL size_t count(T const* p, size_t n, T value) {
+  size_t c{0};
+  for (size_t i = 0; i < n; ++i) c += (p[i] == value);
+  return c;
+}
+
+// Returns the index of the first position where neither element is less than
+// the other, or n.
+template <typename T>
+XTD_SIMD_KERNEL size_t mismatch(T const* a, T const* b, size_t n) {
+  constexpr size_t L = lanes<T>();
+  size_t i{0};
+  for (; i + L <= n; i += L) {
+    bool any{false};
+    for (size_t j = 0; j < L; ++j)
+      any |= (a[i + j] < b[i + j]) | (b[i + j] < a[i + j]);
+    if (any) break;
+  }
+  for (; i < n; ++i)
+    if ((a[i] < b[i]) || (b[i] < a[i])) return i;
+  return n;
+}
+
+// Returns whether all the elements compare equal.
+template <typename T>
+XTD_SIMD_KERNEL bool equal(T const* a, T const* b, size_t n) {
+  constexpr size_t L = lanes<T>();
+  size_t i{0};
+  for (; i + L <= n; i += L) {
+    bool all{true};
+    for (size_t j = 0; j < L; ++j) all &= (a[i + j] == b[i + j]);
+    if (!all) return false;
+  }
+  for (; i < n; ++i)
+    if (!(a[i] == b[i])) return false;
+  return true;
+}
+
+#undef XTD_SIMD_KERNEL
+
+// Instantiates the kernels for one instruction set.
+#define XTD_SIMD_ISA(isa, attributes)                                        \
+  struct isa {                                                               \
+    template <typename T>                                                    \
+    attributes static sum_t<T> sum(T const* p, size_t n) {                   \
+      return detail::sum(p, n);                                              \
+    }                                                                        \
+    template <typename T>                                                    \
+    attributes static std::pair<T, T> minmax(T const* p, size_t n) {         \
+      return detail::minmax(p, n);                                           \
+    }                                                                        \
+    template <typename T>                                                    \
+    attributes static size_t find(T const* p, size_t n, T value) {           \
+      return detail::find(p, n, value);                                      \
+    }                                                                        \
+    template <typename T>                                                    \
+    attributes static size_t count(T const* p, size_t n, T value) {          \
+      return detail::count(p, n, value);                                     \
+    }                                                                        \
+    template <typename T>                                                    \
+    attributes static size_t mismatch(T const* a, T const* b, size_t n) {    \
+      return detail::mismatch(a, b, n);                                      \
+    }                                                                        \
+    template <typename T>                                                    \
+    attributes static bool equal(T const* a, T const* b, size_t n) {         \
+      return detail::equal(a, b, n);                                         \
+    }                                                                        \
+  };
+
+XTD_SIMD_ISA(baseline, )
+#if XTD_SIMD_X86
+XTD_SIMD_ISA(avx2, __attribute__((target("avx2"))))
+#endif
+
+#undef XTD_SIMD_ISA
+
+inline bool has_avx2() {
+#if XTD_SIMD_X86
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+// Calls `fn` with the kernels for the best instruction set of this CPU.
+template <typename Fn>
+decltype(auto) dispatch(Fn&& fn) {
+#if XTD_SIMD_X86
+  if (has_avx2()) return fn(avx2{});
+#endif
+  return fn(baseline{});
+}
+
+// Calls `fn(a, b, count)` for the runs where the spans of `x` and `y` overlap,
+// until it reports visiting fewer than `count` elements. Returns the number of
+// elements visited.
+template <typename X, typename Y, typename Fn>
+size_t zip_spans(X const& x, Y const& y, Fn&& fn) {
+  auto xs = x.segments().begin();
+  auto ys = y.segments().begin();
+  const size_t size = (x.size() < y.size()) ? x.size() : y.size();
+  size_t xi{0};
+  size_t yi{0};
+  size_t done{0};
+  while (done < size) {
+    const size_t count = std::min({xs->size - xi, ys->size - yi, size - done});
+    const size_t visited = fn(xs->data + xi, ys->data + yi, count);
+    done += visited;
+    if (visited < count) break;
+    if ((xi += count) == xs->size) ++xs, xi = 0;
+    if ((yi += count) == ys->size) ++ys, yi = 0;
+  }
+  return done;
+}
+
+template <typename T>
+using if_arithmetic = std::enable_if_t<std::is_arithmetic<T>::value>;
+}
+
+template <typename Vector, typename T = typename Vector::value_type,
+          typename = detail::if_arithmetic<T>>
+sum_t<T> sum(Vector const& v) {
+  return detail::dispatch([&v](auto isa) {
+    sum_t<T> total{};
+    for (auto const& s : v.segments()) total += isa.sum(s.data, s.size);
+    return total;
+  });
+}
+
+template <typename Vector, typename T = typename Vector::value_type,
+          typename = detail::if_arithmetic<T>>
+optional<std::pair<T, T>> minmax(Vector const& v) {
+  if (v.empty()) return none{};
+  return some(detail::dispatch([&v](auto isa) {
+    // seeded from the first span, since columns have no begin()
+    std::pair<T, T> result{};
+    bool seeded{false};
+    v.for_each_span([&](auto const& s) {
+      if (!s.size) return;
+      const auto run = isa.minmax(s.data, s.size);
+      if (!seeded) {
+        result = run;
+        seeded = true;
+        return;
+      }
+      result.first = (run.first < result.first) ? run.first : result.first;
+      result.second = (result.second < run.second) ? run.second : result.second;
+    });
+    return result;
+  }));
+}
+
+// The index of the first element equal to `value`.
+template <typename Vector, typename T = typename Vector::value_type,
+          typename = detail::if_arithmetic<T>>
+optional<size_t> find(Vector const& v, T value) {
+  return detail::dispatch([&](auto isa) -> optional<size_t> {
+    size_t first{0};
+    for (auto const& s : v.segments()) {
+      const size_t i = isa.find(s.data, s.size, value);
+      if (i < s.size) return some(first + i);
+      first += s.size;
+    }
+    return none{};
+  });
+}
+
+template <typename Vector, typename T = typename Vector::value_type,
+          typename = detail::if_arithmetic<T>>
+size_t count(Vector const& v, T value) {
+  return detail::dispatch([&](auto isa) {
+    size_t c{0};
+    for (auto const& s : v.segments()) c += isa.count(s.data, s.size, value);
+    return c;
+  });
+}
+
+template <typename X, typename Y, typename T = typename X::value_type,
+          typename = detail::if_arithmetic<T>>
+bool equal(X const& x, Y const& y) {
+  static_assert(std::is_same<T, typename Y::value_type>::value,
+                "Both vectors need to have the same element type.");
+  if (x.size() != y.size()) return false;
+  return detail::dispatch([&](auto isa) {
+    return detail::zip_spans(x, y, [isa](T const* a, T const* b, size_t n) {
+             return isa.equal(a, b, n) ? n : 0;
+           }) == x.size();
+  });
+}
+
+template <typename X, typename Y, typename T = typename X::value_type,
+          typename = detail::if_arithmetic<T>>
+bool lexicographical_compare(X const& x, Y const& y) {
+  static_assert(std::is_same<T, typename Y::value_type>::value,
+                "Both vectors need to have the same element type.");
+  return detail::dispatch([&](auto isa) {
+    optional<bool> less;
+    detail::zip_spans(x, y, [isa, &less](T const* a, T const* b, size_t n) {
+      const size_t i = isa.mismatch(a, b, n);
+      if (i < n) less = some(a[i] < b[i]);
+      return i;
+    });
+    return less.match([](bool l) { return l; },
+                      [&]() { return x.size() < y.size(); });
+  });
+}
+}
+}
@@ -0,0 +1,324 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memory_resource.hh"
+#include "optional.hh"
+#include "span.hh"
+#include "superblock.hh"
+
+namespace xtd {
+
+// A vector of rows with the fields `Fields...`, stored as one column per
+// field. It grows like xtd::vector: data block b holds
+// superblock::block_length(b) segments of 2^N rows, and never moves once
+// allocated. Every data block is a single allocation holding one contiguous,
+// cache line aligned column per field, so a loop over the spans of one
+// column only touches the memory of that field.
+template <uint8_t N, typename... Fields>
+class basic_soa_vector {
+  static_assert(sizeof...(Fields) > 0, "A row needs at least one field.");
+
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
+  static constexpr size_t columns = sizeof...(Fields);
+  static constexpr size_t column_alignment = 64;
+
+  template <size_t I>
+  using field_t = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+  using sequence = std::index_sequence_for<Fields...>;
+
+  struct block {
+    void* base;
+    size_t bytes;
+    size_t rows;
+    std::array<void*, columns> column;
+  };
+
+  memory_resource* m_resource;
+  std::vector<block> m_data;
+  size_t m_size{0};
+
+  // The data block holding the next row, and the next row's index in it.
+  size_t m_block{0};
+  size_t m_offset{0};
+
+  static size_t align(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) & ~(alignment - 1);
+  }
+
+  static constexpr size_t alignment_of(size_t a) {
+    return (a > column_alignment) ? a : column_alignment;
+  }
+
+  void allocate_block() {
+    const size_t rows = superblock::block_length(m_data.size()) << N;
+    const size_t sizes[] = {rows * sizeof(Fields)...};
+    const size_t alignments[] = {alignment_of(alignof(Fields))...};
+
+    block b{nullptr, 0, rows, {}};
+    std::array<size_t, columns> offsets;
+    size_t max_alignment{column_alignment};
+    for (size_t i = 0; i < columns; ++i) {
+      offsets[i] = b.bytes = align(b.bytes, alignments[i]);
+      b.bytes += sizes[i];
+      max_alignment = (alignments[i] > max_alignment) ? alignments[i]
+                                                      : max_alignment;
+    }
+    // room for the block first, so that push_back cannot throw and leak it
+    if (m_data.size() == m_data.capacity())
+      m_data.reserve(2 * m_data.size() + 1);
+    b.base = m_resource->allocate(b.bytes, max_alignment);
+    for (size_t i = 0; i < columns; ++i)
+      b.column[i] = static_cast<char*>(b.base) + offsets[i];
+    m_data.push_back(b);
+  }
+
+  void deallocate_block() {
+    block const& b = m_data.back();
+    size_t max_alignment{column_alignment};
+    for (size_t a : {alignment_of(alignof(Fields))...})
+      max_alignment = (a > max_alignment) ? a : max_alignment;
+    m_resource->deallocate(b.base, b.bytes, max_alignment);
+    m_data.pop_back();
+  }
+
+  template <size_t I>
+  static field_t<I>* column_data(block const& b) {
+    return static_cast<field_t<I>*>(b.column[I]);
+  }
+
+  // Constructs the fields of a row in order, destroying the ones already
+  // constructed if one of them throws.
+  template <size_t... I, typename... Args>
+  static void construct(std::index_sequence<I...>, block const& b,
+                        size_t offset, Args&&... args) {
+    size_t constructed{0};
+    try {
+      int expand[] = {(new (column_data<I>(b) + offset)
+                           field_t<I>(std::forward<Args>(args)),
+                       ++constructed, 0)...};
+      (void)expand;
+    } catch (...) {
+      destroy(sequence{}, b, offset, constructed);
+      throw;
+    }
+  }
+
+  template <typename T>
+  static int destroy_one(T& t) {
+    t.~T();
+    return 0;
+  }
+
+  // Destroys the first `count` fields of a row.
+  template <size_t... I>
+  static void destroy(std::index_sequence<I...>, block const& b,
+                      size_t offset, size_t count = columns) {
+    int expand[] = {
+        ((I < count) ? destroy_one(column_data<I>(b)[offset]) : 0)...};
+    (void)expand;
+  }
+
+  template <size_t... I>
+  static auto row(std::index_sequence<I...>, block const& b, size_t offset) {
+    return std::tuple<Fields&...>{column_data<I>(b)[offset]...};
+  }
+
+  template <size_t... I>
+  static auto take(std::index_sequence<I...>, block const& b, size_t offset) {
+    return std::tuple<Fields...>{std::move(column_data<I>(b)[offset])...};
+  }
+
+  std::pair<block const*, size_t> locate(size_t p) const {
+    const auto loc = superblock::locate(p >> N);
+    return {&m_data[loc.block],
+            (loc.segment << N) + (p & (segmentCapacity() - 1))};
+  }
+
+  template <size_t I, typename T>
+  class column_iterator_t
+      : public std::iterator<std::forward_iterator_tag, span<T> const> {
+    basic_soa_vector const* v{nullptr};
+    size_t b{0};
+    size_t first{0};
+    span<T> s{nullptr, 0};
+
+    void load() {
+      if (first < v->size()) {
+        block const& blk = v->m_data[b];
+        const size_t left = v->size() - first;
+        s = {column_data<I>(blk), (left < blk.rows) ? left : blk.rows};
+      }
+    }
+
+   public:
+    column_iterator_t() = default;
+    column_iterator_t(basic_soa_vector const& v, size_t b, size_t first)
+        : v{&v}, b{b}, first{first} {
+      load();
+    }
+
+    bool operator==(column_iterator_t const& it) const {
+      return (first == it.first) && (v == it.v);
+    }
+    bool operator!=(column_iterator_t const& it) const {
+      return !(*this == it);
+    }
+
+    auto& operator++() {
+      first += s.size;
+      ++b;
+      load();
+      return *this;
+    }
+    auto operator++(int) {
+      column_iterator_t it{*this};
+      ++(*this);
+      return it;
+    }
+
+    auto const& operator*() const { return s; }
+    auto const* operator->() const { return &s; }
+  };
+
+ public:
+  using value_type = std::tuple<Fields...>;
+  using reference = std::tuple<Fields&...>;
+  using const_reference = std::tuple<Fields const&...>;
+
+  // The fields with index I of all the rows, one span per data block. It can
+  // stand in for a vector in the span-based algorithms.
+  template <size_t I, typename T>
+  class column_t {
+    basic_soa_vector const* v;
+
+   public:
+    using value_type = std::remove_const_t<T>;
+
+    explicit column_t(basic_soa_vector const& v) : v{&v} {}
+
+    size_t size() const { return v->size(); }
+    bool empty() const { return v->empty(); }
+
+    struct range {
+      column_iterator_t<I, T> b;
+      column_iterator_t<I, T> e;
+      auto begin() const { return b; }
+      auto end() const { return e; }
+    };
+
+    range segments() const {
+      return {{*v, 0, 0}, {*v, v->m_data.size(), v->size()}};
+    }
+
+    template <typename Fn>
+    void for_each_span(Fn&& fn) const {
+      for (auto const& s : segments()) fn(s);
+    }
+  };
+
+  basic_soa_vector() : basic_soa_vector{new_delete_resource()} {}
+
+  // Creates a vector whose data blocks are allocated from `resource`, which
+  // has to outlive it.
+  explicit basic_soa_vector(memory_resource* resource)
+      : m_resource{resource} {}
+
+  basic_soa_vector(basic_soa_vector const&) = delete;
+  basic_soa_vector& operator=(basic_soa_vector const&) = delete;
+
+  ~basic_soa_vector() {
+    for (size_t b = 0, left = m_size; left; ++b) {
+      const size_t rows = (left < m_data[b].rows) ? left : m_data[b].rows;
+      for (size_t offset = 0; offset < rows; ++offset)
+        destroy(sequence{}, m_data[b], offset);
+      left -= rows;
+    }
+    while (!m_data.empty()) deallocate_block();
+  }
+
+  memory_resource* resource() const { return m_resource; }
+
+  // Appends a row with its fields constructed from `args`, one argument per
+  // field. The row is located once for all the columns.
+  template <typename... Args>
+  basic_soa_vector& push(Args&&... args) {
+    static_assert(sizeof...(Args) == columns,
+                  "push takes one argument per field.");
+    if (m_block < m_data.size() && m_offset == m_data[m_block].rows) {
+      ++m_block;
+      m_offset = 0;
+    }
+    if (m_block == m_data.size()) allocate_block();
+    construct(sequence{}, m_data[m_block], m_offset,
+              std::forward<Args>(args)...);
+    ++m_offset;
+    ++m_size;
+    return *this;
+  }
+
+  optional<value_type> pop() {
+    if (empty()) return none{};
+    if (m_offset == 0) m_offset = m_data[--m_block].rows;
+    block const& b = m_data[m_block];
+    --m_offset;
+    --m_size;
+    value_type row = take(sequence{}, b, m_offset);
+    destroy(sequence{}, b, m_offset);
+
+    // keep at most one spare data block
+    if (m_data.size() > m_block + 2) deallocate_block();
+    return some(std::move(row));
+  }
+
+  size_t size() const { return m_size; }
+
+  bool empty() const { return m_size == 0; }
+
+  optional<reference> operator[](size_t p) {
+    if (p >= size()) return none{};
+    const auto at = locate(p);
+    return optional<reference>{row(sequence{}, *at.first, at.second)};
+  }
+
+  optional<const_reference> operator[](size_t p) const {
+    if (p >= size()) return none{};
+    const auto at = locate(p);
+    return optional<const_reference>{row(sequence{}, *at.first, at.second)};
+  }
+
+  optional<reference> back() { return (*this)[size() - 1]; }
+
+  optional<const_reference> back() const { return (*this)[size() - 1]; }
+
+  template <size_t I>
+  column_t<I, field_t<I>> column() {
+    return column_t<I, field_t<I>>{*this};
+  }
+
+  template <size_t I>
+  column_t<I, field_t<I> const> column() const {
+    return column_t<I, field_t<I> const>{*this};
+  }
+
+  // Calls `fn` with the span of every data block in the column of field I.
+  template <size_t I, typename Fn>
+  void for_each_span(Fn&& fn) {
+    column<I>().for_each_span(std::forward<Fn>(fn));
+  }
+
+  template <size_t I, typename Fn>
+  void for_each_span(Fn&& fn) const {
+    column<I>().for_each_span(std::forward<Fn>(fn));
+  }
+};
+
+template <typename... Fields>
+using soa_vector = basic_soa_vector<0, Fields...>;
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_algorithms.hh"
+#include "span.hh"
+
+namespace xtd {
+
+namespace detail {
+
+// The position where the first `d` elements of the stable merge of `a` and
+// `b` end in `a`. Elements of `a` go first when equal.
+template <typename T, typename Compare>
+size_t merge_path(span<T> a, span<T> b, size_t d, Compare& comp) {
+  size_t lo = (d > b.size) ? d - b.size : 0;
+  size_t hi = (d < a.size) ? d : a.size;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (comp(b.data[d - mid - 1], a.data[mid]))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+struct merge_task {
+  size_t pair;   // the index of the pair of runs to merge
+  size_t first;  // the part of their merged output this task writes
+  size_t last;
+};
+
+// Merges neighbouring pairs of `runs`, which hold consecutive elements, into
+// `out` and returns the merged runs. Long merges are split at their merge
+// path so that every round keeps all the threads busy.
+template <typename T, typename Compare>
+std::vector<span<T>> merge_round(std::vector<span<T>> const& runs, T* out,
+                                 size_t threads, Compare& comp) {
+  std::vector<span<T>> merged;
+  std::vector<size_t> offsets;
+  std::vector<merge_task> tasks;
+  size_t offset{0};
+  for (size_t i = 0; i < runs.size(); i += 2) {
+    const size_t size = runs[i].size +
+                        ((i + 1 < runs.size()) ? runs[i + 1].size : 0);
+    for (size_t first = 0; first < size; first += parallel_grain)
+      tasks.push_back(
+          {i / 2, first, std::min(first + parallel_grain, size)});
+    merged.push_back({out + offset, size});
+    offsets.push_back(offset);
+    offset += size;
+  }
+
+  run(tasks, threads, [&](size_t, merge_task const& t) {
+    const span<T> a = runs[2 * t.pair];
+    const span<T> b = (2 * t.pair + 1 < runs.size()) ? runs[2 * t.pair + 1]
+                                                     : span<T>{a.data, 0};
+    const size_t a_first = merge_path(a, b, t.first, comp);
+    const size_t a_last = merge_path(a, b, t.last, comp);
+    std::merge(std::make_move_iterator(a.data + a_first),
+               std::make_move_iterator(a.data + a_last),
+               std::make_move_iterator(b.data + t.first - a_first),
+               std::make_move_iterator(b.data + t.last - a_last),
+               out + offsets[t.pair] + t.first, comp);
+  });
+  return merged;
+}
+
+// Maps arithmetic keys to unsigned integers of the same size that order the
+// same way.
+template <typename T, typename = void>
+struct radix_key {
+  using type = std::make_unsigned_t<T>;
+  static type get(T t) {
+    type u;
+    std::memcpy(&u, &t, sizeof(T));
+    return std::is_signed<T>::value
+               ? u ^ (type{1} << (8 * sizeof(T) - 1))
+               : u;
+  }
+};
+
+template <typename T>
+struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  using type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+  static type get(T t) {
+    type u;
+    std::memcpy(&u, &t, sizeof(T));
+    const type sign = type{1} << (8 * sizeof(T) - 1);
+    return (u & sign) ? ~u : (u | sign);
+  }
+};
+
+// Writes elements one after the other across a range of spans.
+template <typename Spans>
+class span_writer {
+  using iterator = decltype(std::declval<Spans&>().begin());
+
+  iterator m_span;
+  decltype(m_span->data) m_next{nullptr};
+  decltype(m_span->data) m_end{nullptr};
+
+ public:
+  explicit span_writer(Spans const& spans) : m_span{spans.begin()} {}
+
+  template <typename T>
+  void write(T&& t) {
+    if (m_next == m_end) {
+      m_next = m_span->data;
+      m_end = m_next + m_span->size;
+      ++m_span;
+    }
+    *m_next++ = std::forward<T>(t);
+  }
+};
+}
+
+// Sorts the elements of `v` with `comp` on up to `threads` threads. Every
+// data block is sorted on its own and the sorted blocks are then merged in
+// rounds that alternate between two buffers as large as `v`, so the sort
+// takes up to twice the memory of `v` and elements need to be default
+// constructible as well as movable. The sort is not stable.
+template <typename Vector, typename Compare = std::less<>>
+void parallel_sort(Vector& v, Compare comp = {},
+                   size_t threads = detail::default_concurrency()) {
+  using T = typename Vector::value_type;
+  std::vector<detail::chunk<T>> blocks;
+  std::vector<span<T>> runs;
+  size_t first{0};
+  for (auto const& s : v.segments()) {
+    blocks.push_back({first, s});
+    runs.push_back(s);
+    first += s.size;
+  }
+  detail::run(blocks, threads, [&comp](size_t, detail::chunk<T> const& c) {
+    std::sort(c.elements.begin(), c.elements.end(), comp);
+  });
+  if (runs.size() < 2) return;
+
+  // the second buffer is only allocated when there is a second round
+  std::vector<T> buffers[2] = {std::vector<T>(v.size()), {}};
+  for (size_t round = 0; runs.size() > 1; ++round) {
+    auto& out = buffers[round & 1];
+    if (out.empty()) out.resize(v.size());
+    runs = detail::merge_round(runs, out.data(), threads, comp);
+  }
+
+  T* sorted = runs.front().data;
+  detail::run(blocks, threads, [sorted](size_t, detail::chunk<T> const& c) {
+    std::move(sorted + c.first, sorted + c.first + c.elements.size,
+              c.elements.data);
+  });
+}
+
+// Sorts the elements of `v` with `comp` on the calling thread.
+template <typename Vector, typename Compare = std::less<>>
+void sort(Vector& v, Compare comp = {}) {
+  parallel_sort(v, comp, 1);
+}
+
+namespace detail {
+// The element types radix_key maps to an unsigned integer of the same size:
+// integers of up to 64 bits other than bool, float and double.
+template <typename T>
+using if_radix_sortable = std::enable_if_t<
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+     sizeof(T) <= sizeof(uint64_t)) ||
+    std::is_same<T, float>::value || std::is_same<T, double>::value>;
+}
+
+// Sorts the arithmetic elements of `v` in ascending order with a least
+// significant digit radix sort, one byte per pass. Every pass reads the
+// elements block by block and writes each digit's elements block by block,
+// alternating between `v` and a buffer as large as it. The histograms of all
+// the digits are counted in a single read, and passes in which all the
+// elements share the same digit are skipped. Negative zero sorts before
+// positive zero, and NaNs sort before or after all the other elements
+// depending on their sign bit.
+template <typename Vector, typename T = typename Vector::value_type,
+          typename = detail::if_radix_sortable<T>>
+void radix_sort(Vector& v) {
+  using key = detail::radix_key<T>;
+  constexpr size_t digits = sizeof(typename key::type);
+  constexpr size_t radix = 256;
+  const size_t size = v.size();
+  if (size < 2) return;
+
+  std::vector<T> buffer(size);
+  const span<T> flat{buffer.data(), size};
+  bool in_buffer{false};
+
+  // the histograms of all the digits, which the passes do not change
+  size_t counts[digits][radix] = {};
+  v.for_each_span([&counts](span<T> s) {
+    for (T t : s) {
+      const auto k = key::get(t);
+      for (size_t pass = 0; pass < digits; ++pass)
+        ++counts[pass][(k >> (8 * pass)) & 0xff];
+    }
+  });
+
+  for (size_t pass = 0; pass < digits; ++pass) {
+    const size_t shift = 8 * pass;
+    auto digit = [shift](T t) { return (key::get(t) >> shift) & 0xff; };
+    size_t const* count = counts[pass];
+    if (std::find(count, count + radix, size) != count + radix) continue;
+
+    size_t first{0};
+    if (in_buffer) {
+      using spans = decltype(v.segments(0, 0));
+      std::vector<detail::span_writer<spans>> out;
+      out.reserve(radix);
+      for (size_t d = 0; d < radix; first += count[d++])
+        out.emplace_back(v.segments(first, first + count[d]));
+      for (T t : flat) out[digit(t)].write(t);
+    } else {
+      T* out[radix];
+      for (size_t d = 0; d < radix; first += count[d++])
+        out[d] = buffer.data() + first;
+      v.for_each_span([&](span<T> s) {
+        for (T t : s) *out[digit(t)]++ = t;
+      });
+    }
+    in_buffer = !in_buffer;
+  }
+
+  if (in_buffer) {
+    size_t first{0};
+    v.for_each_span([&](span<T> s) {
+      std::copy(buffer.data() + first, buffer.data() + first + s.size,
+                s.data);
+      first += s.size;
+    });
+  }
+}
+}
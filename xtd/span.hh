@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace xtd {
+
+// A contiguous run of `size` objects of type T starting at `data`.
+template <typename T>
+struct span {
+  T* data;
+  size_t size;
+
+  T* begin() const { return data; }
+  T* end() const { return data + size; }
+
+  bool empty() const { return size == 0; }
+};
+}
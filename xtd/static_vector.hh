@@ -0,0 +1,206 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "array.hh"
+#include "optional.hh"
+#include "span.hh"
+
+namespace xtd {
+
+namespace detail {
+
+// The narrowest unsigned type that can count to `Capacity`. A uint8_t is left
+// out: it may alias the elements, so every store to one would reload the size.
+template <size_t Capacity>
+using static_size_t = std::conditional_t<
+    (Capacity <= UINT16_MAX), uint16_t,
+    std::conditional_t<(Capacity <= UINT32_MAX), uint32_t, size_t>>;
+
+// The elements of a static_vector. Trivially copyable elements are copied as
+// the raw bytes of the whole array, which keeps the vector trivially copyable
+// too; other elements are copied and destroyed one by one.
+template <typename T, size_t Capacity,
+          bool = std::is_trivially_copyable<T>::value>
+struct static_vector_storage {
+  array<T, std::aligned_storage_t<sizeof(T), alignof(T)>[Capacity]> m_data;
+  static_size_t<Capacity> m_size{0};
+};
+
+template <typename T, size_t Capacity>
+struct static_vector_storage<T, Capacity, false> {
+  array<T, std::aligned_storage_t<sizeof(T), alignof(T)>[Capacity]> m_data;
+  static_size_t<Capacity> m_size{0};
+
+  void destroy_all() {
+    for (; m_size; --m_size) m_data[m_size - 1].~T();
+  }
+
+  // Constructs the elements of `other` after destroying the ones held, and
+  // leaves none behind if one of them throws.
+  template <typename Storage, typename Construct>
+  void construct_from(Storage& other, Construct&& construct) {
+    destroy_all();
+    try {
+      for (; m_size < other.m_size; ++m_size)
+        construct(m_data.overwrite(m_size), other.m_data[m_size]);
+    } catch (...) {
+      destroy_all();
+      throw;
+    }
+  }
+
+  void copy_from(static_vector_storage const& other) {
+    construct_from(other, [](emplacer<T> to, T const& t) { to.emplace(t); });
+  }
+
+  void move_from(static_vector_storage& other) {
+    construct_from(
+        other, [](emplacer<T> to, T& t) { to.emplace(std::move(t)); });
+  }
+
+  static_vector_storage() = default;
+
+  static_vector_storage(static_vector_storage const& other) {
+    copy_from(other);
+  }
+
+  static_vector_storage(static_vector_storage&& other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    move_from(other);
+  }
+
+  static_vector_storage& operator=(static_vector_storage const& other) {
+    if (this != &other) copy_from(other);
+    return *this;
+  }
+
+  static_vector_storage& operator=(static_vector_storage&& other) {
+    if (this != &other) move_from(other);
+    return *this;
+  }
+
+  ~static_vector_storage() { destroy_all(); }
+};
+}
+
+// A vector of at most `Capacity` elements stored inline, which never
+// allocates, e.g. a per-packet scratch buffer. It has the optional-returning
+// operator[], back() and pop() of xtd::vector, and like mapped_vector its
+// push reports whether there was room for the element.
+//
+// It is trivially copyable when T is, e.g. so that it can be copied with
+// memcpy into a packet. Its capacity is a constant expression; its elements
+// cannot be, since C++14 does not allow placing objects in raw storage there.
+template <typename T, size_t Capacity>
+class static_vector : detail::static_vector_storage<T, Capacity> {
+  static_assert(Capacity > 0, "A static_vector needs room for an element.");
+
+  template <typename U>
+  struct span_range_t {
+    // Holds the span rather than pointing into the range, so that it stays
+    // valid after a temporary range is gone.
+    struct iterator {
+      span<U> s;
+      bool end;
+
+      span<U> const& operator*() const { return s; }
+      span<U> const* operator->() const { return &s; }
+      iterator& operator++() {
+        end = true;
+        return *this;
+      }
+      bool operator==(iterator const& it) const { return end == it.end; }
+      bool operator!=(iterator const& it) const { return end != it.end; }
+    };
+
+    span<U> s;
+
+    iterator begin() const { return {s, s.size == 0}; }
+    iterator end() const { return {s, true}; }
+  };
+
+  T take_last() {
+    T& last = this->m_data[this->m_size - 1];
+    T result{std::move(last)};
+    last.~T();
+    --this->m_size;
+    return result;
+  }
+
+  template <typename Vector>
+  static auto at(Vector& v, size_t p) {
+    using value_t = std::conditional_t<std::is_const<Vector>::value, T const,
+                                       T>;
+    using result_t = optional<std::reference_wrapper<value_t>>;
+    if (p >= v.size()) return result_t{none{}};
+    return result_t{std::ref<value_t>(v.m_data[p])};
+  }
+
+ public:
+  using value_type = T;
+
+  static constexpr size_t capacity() { return Capacity; }
+
+  constexpr size_t size() const { return this->m_size; }
+
+  constexpr bool empty() const { return this->m_size == 0; }
+
+  constexpr bool full() const { return this->m_size == Capacity; }
+
+  // Constructs an element at the end. Returns false, leaving the vector
+  // unchanged, when it is full.
+  template <typename... Args>
+  bool push(Args&&... args) {
+    if (full()) return false;
+    this->m_data.overwrite(this->m_size).emplace(std::forward<Args>(args)...);
+    ++this->m_size;
+    return true;
+  }
+
+  optional<T> pop() {
+    if (empty()) return none{};
+    return some(take_last());
+  }
+
+  static_vector& clear() {
+    for (; this->m_size; --this->m_size) this->m_data[this->m_size - 1].~T();
+    return *this;
+  }
+
+  auto operator[](size_t p) { return at(*this, p); }
+
+  auto operator[](size_t p) const { return at(*this, p); }
+
+  auto back() { return at(*this, size() - 1); }
+
+  auto back() const { return at(*this, size() - 1); }
+
+  T* data() { return &this->m_data[0]; }
+  T const* data() const { return &this->m_data[0]; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size(); }
+
+  T const* begin() const { return data(); }
+  T const* end() const { return data() + size(); }
+
+  // The elements as a single span, for the algorithms that take the segments
+  // of an xtd::vector.
+  auto segments() { return span_range_t<T>{{data(), size()}}; }
+  auto segments() const { return span_range_t<T const>{{data(), size()}}; }
+
+  template <typename Fn>
+  void for_each_span(Fn&& fn) {
+    if (!empty()) fn(span<T>{data(), size()});
+  }
+  template <typename Fn>
+  void for_each_span(Fn&& fn) const {
+    if (!empty()) fn(span<T const>{data(), size()});
+  }
+};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xtd {
+
+// Index arithmetic of the layout from "Resizable Arrays in Optimal Time and
+// Space" (Brodnik et al.), shared by the containers built on it. Segments are
+// numbered from 0 and grouped into data blocks, which are in turn grouped into
+// superblocks: superblock k holds 2^floor(k/2) data blocks of 2^ceil(k/2)
+// segments each. Data blocks are numbered from 0 across superblocks.
+namespace superblock {
+
+// The index of the most significant bit set in `x`, which must not be 0.
+constexpr size_t log2(uint64_t x) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(x);
+#else
+  size_t k{0};
+  while (x >>= 1) ++k;
+  return k;
+#endif
+}
+
+// The number of data blocks in superblock `k`.
+constexpr size_t blocks(size_t k) { return size_t{1} << (k >> 1); }
+
+// The number of segments in each of the data blocks of superblock `k`.
+constexpr size_t length(size_t k) { return size_t{1} << ((k + 1) >> 1); }
+
+// The index of the first data block in superblock `k`.
+constexpr size_t first_block(size_t k) {
+  return ((blocks(k) - 1) << 1) + (k & 1) * blocks(k);
+}
+
+// The number of segments in the data block with index `b`.
+constexpr size_t block_length(size_t b) {
+  size_t k{0};
+  for (; b >= blocks(k); ++k) b -= blocks(k);
+  return length(k);
+}
+
+// The number of segments in the first `count` data blocks.
+constexpr size_t segments_in(size_t count) {
+  size_t k{0};
+  for (; count > blocks(k); ++k) count -= blocks(k);
+  // superblocks 0..k-1 hold 2^k - 1 segments
+  return (size_t{1} << k) - 1 + count * length(k);
+}
+
+struct location {
+  size_t superblock;  // the index of the superblock
+  size_t block;       // the index of the data block
+  size_t segment;     // the index of the segment in the data block
+  size_t length;      // the number of segments in the data block
+};
+
+// Finds the data block holding the segment with index `pos`. Segment p lives
+// in superblock k = log2(p + 1); below the leading bit of p + 1, the next
+// floor(k/2) bits select the data block and the last ceil(k/2) bits the
+// segment inside it.
+constexpr location locate(size_t pos) {
+  const uint64_t p = uint64_t{pos} + 1;
+  const size_t k = log2(p);
+  const size_t segment_bits = (k + 1) >> 1;
+  const uint64_t b = (p >> segment_bits) & (blocks(k) - 1);
+  const uint64_t segment = p & (length(k) - 1);
+  return {k, first_block(k) + b, segment, length(k)};
+}
+}
+}
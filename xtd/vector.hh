@@ -1,11 +1,17 @@
 #pragma once
+#include <cstring>
 #include <iterator>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "array.hh"
+#include "memory_resource.hh"
 #include "optional.hh"
+#include "span.hh"
+#include "superblock.hh"
+#include "vector_stats.hh"
 
 namespace xtd {
 
@@ -18,32 +24,249 @@ auto opt_ref(U const&, T const& t) { return std::ref(t); };
 template<typename T, typename U>
 auto opt_ref(U&&, T&& t) { return std::move(t); };
 
-template <typename T, uint8_t N = 0>
+// The largest N for which a segment of 2^N objects of type T fits in `bytes`.
+template <typename T>
+constexpr uint8_t segment_bits(size_t bytes) {
+  uint8_t n{0};
+  while ((sizeof(T) << (n + 1)) <= bytes) ++n;
+  return n;
+}
+
+// Segment sizes matching a cache line and a page, e.g.
+// xtd::vector<T, xtd::cache_line_segment<T>>.
+template <typename T>
+constexpr uint8_t cache_line_segment = segment_bits<T>(64);
+
+template <typename T>
+constexpr uint8_t page_segment = segment_bits<T>(4096);
+
+// How many empty data blocks a container keeps allocated when it shrinks, so
+// that growing again does not have to allocate them anew.
+class retention {
+ public:
+  enum class kind { spare_blocks, slack_percent, until_shrink };
+
+  // Keeps up to `count` empty data blocks.
+  static constexpr retention spare_blocks(size_t count) {
+    return {kind::spare_blocks, count};
+  }
+
+  // Keeps empty data blocks while the capacity is at most `percent` percent
+  // larger than the size.
+  static constexpr retention slack_percent(size_t percent) {
+    return {kind::slack_percent, percent};
+  }
+
+  // Keeps all the data blocks until shrink_to_fit.
+  static constexpr retention until_shrink() { return {kind::until_shrink, 0}; }
+
+  constexpr kind policy() const { return m_kind; }
+  constexpr size_t value() const { return m_value; }
+
+  // Whether to release the last of `blocks` allocated data blocks, of which
+  // the first `used` hold elements. `capacity` is the number of segments in
+  // all the blocks and `size` the number of segments in use.
+  constexpr bool release(size_t blocks, size_t used, size_t capacity,
+                         size_t size) const {
+    return (blocks > used) &&
+           ((m_kind == kind::spare_blocks && blocks - used > m_value) ||
+            (m_kind == kind::slack_percent &&
+             capacity * 100 > size * (100 + m_value)));
+  }
+
+ private:
+  constexpr retention(kind k, size_t value) : m_kind{k}, m_value{value} {}
+
+  kind m_kind;
+  size_t m_value;
+};
+
+// A vector of segments of 2^N elements laid out in superblocks. `Size` is the
+// type of its counters: the default counts as far as memory goes, while a
+// 32-bit `Size` keeps the vector smaller but limits it to 2^32 - 1 segments.
+//
+// The first superblocks are stored inline, enough for at least four
+// elements, so that small vectors do not allocate at all.
+template <typename T, uint8_t N = 0, typename Size = size_t>
 class vector {
-  static constexpr size_t segmentCapacity() { return 1 << N; }
+  static_assert(std::is_unsigned<Size>::value && N < 8 * sizeof(Size),
+                "The counters have to be unsigned and wider than N.");
+
+  static constexpr size_t segmentCapacity() { return size_t{1} << N; }
   static constexpr size_t segmentSize() {
     return sizeof(T) * segmentCapacity();
   }
 
-  using segment_index_t = int;
-  using index_t = int;
+  // The fewest superblocks holding at least four elements, which are stored
+  // inline, and the data blocks and segments in them.
+  static constexpr size_t inlineSuperblocks() {
+    return (N >= 2) ? 1 : (N == 1) ? 2 : 3;
+  }
+  static constexpr size_t inlineBlocks() {
+    return superblock::first_block(inlineSuperblocks());
+  }
+  static constexpr size_t inlineSegments() {
+    return (size_t{1} << inlineSuperblocks()) - 1;
+  }
+
   using segment_t =
       array<T,
             std::aligned_storage_t<sizeof(T), alignof(T)>[segmentCapacity()]>;
-  using block_t = array<segment_t, std::unique_ptr<segment_t[]>>;
 
-  std::vector<block_t> m_data;  // begin, end
-  uint32_t m_d;
+  template <typename Container>
+  using value_t =
+      std::conditional_t<std::is_const<Container>::value, T const, T>;
+
+  memory_resource* m_resource;
+  retention m_retention{retention::spare_blocks(1)};
+
+  // The data blocks of the inline superblocks, one after the other in the
+  // vector itself, so that creating a vector and filling them does not
+  // allocate. The directory holds the data blocks after them, and stays
+  // empty until then.
+  segment_t m_inline[inlineSegments()];
+
+  // The directory is indexed by superblock: m_directory[k] points to the
+  // superblock::blocks(k) data blocks of superblock k, and is allocated along
+  // with the first of them. The entries of the inline superblocks are null.
+  // The tables never move; the outer level grows geometrically from a few
+  // entries, and since it has one entry per superblock, growing it moves at
+  // most 64 pointers.
+  std::vector<std::unique_ptr<segment_t*[]>> m_directory;
+  size_t m_blocks{inlineBlocks()};  // the number of data blocks
+
+  segment_t* m_tail{m_inline};  // the data block holding the last element
+  bool m_ahead{false};           // whether to allocate the next block early
+  Size m_d;
+
+  Size m_s;
+  Size m_n;
+  Size m_od;
+  Size m_nd;
+  Size m_os;
+  Size m_ns;
+
+  Size m_oseg;
+
+  segment_t* allocate_block(size_t length) {
+    auto p = static_cast<segment_t*>(
+        m_resource->allocate(length * sizeof(segment_t), alignof(segment_t)));
+    for (size_t i = 0; i < length; ++i) new (p + i) segment_t;
+    detail::count_block_allocation(length * sizeof(segment_t));
+    return p;
+  }
+
+  void deallocate_block(segment_t* p, size_t length) {
+    detail::count_block_deallocation(length * sizeof(segment_t));
+    m_resource->deallocate(p, length * sizeof(segment_t), alignof(segment_t));
+  }
 
-  uint32_t m_s;
-  uint32_t m_n;
-  uint32_t m_od;
-  uint32_t m_nd;
-  uint32_t m_os;
-  uint32_t m_ns;
-  bool m_emptyDb;
+  // The number of data blocks, counting the inline ones.
+  size_t blocks() const { return m_blocks; }
 
-  uint32_t m_oseg;
+  // The superblock holding data block `b`, and the index of `b` in it.
+  static std::pair<size_t, size_t> block_position(size_t b) {
+    size_t k{0};
+    for (; b >= superblock::blocks(k); ++k) b -= superblock::blocks(k);
+    return {k, b};
+  }
+
+  // Allocates the data block after the last one.
+  void push_block() {
+    const auto at = block_position(m_blocks);
+    if (m_directory.empty()) {
+      m_directory.reserve(inlineSuperblocks() + 3);
+      m_directory.resize(inlineSuperblocks());
+    }
+    if (m_directory.size() == at.first) {
+      // built first, so that the table is released if push_back throws
+      auto table = std::make_unique<segment_t*[]>(superblock::blocks(at.first));
+      m_directory.push_back(std::move(table));
+    }
+    m_directory[at.first][at.second] =
+        allocate_block(superblock::length(at.first));
+    ++m_blocks;
+  }
+
+  // Releases the last data block, which must not be an inline one.
+  void pop_block() {
+    const auto at = block_position(--m_blocks);
+    deallocate_block(m_directory[at.first][at.second],
+                     superblock::length(at.first));
+    if (at.second == 0) m_directory.resize(at.first);
+  }
+
+  // The first segment of data block `b` of inline superblock `k`.
+  static constexpr size_t inline_segment(size_t k, size_t b) {
+    return (size_t{1} << k) - 1 + b * superblock::length(k);
+  }
+
+  // The data block at `loc`.
+  template <typename Vector>
+  static auto block_data(Vector& v, superblock::location const& loc) {
+    const size_t b = loc.block - superblock::first_block(loc.superblock);
+    return (loc.superblock < inlineSuperblocks())
+               ? &v.m_inline[inline_segment(loc.superblock, b)]
+               : v.m_directory[loc.superblock][b];
+  }
+
+  // The data block the counters point at, i.e. block m_d - 1.
+  segment_t* current_block() {
+    return (m_s <= inlineSuperblocks())
+               ? &m_inline[inline_segment(m_s - 1, m_os - 1)]
+               : m_directory[m_s - 1][m_os - 1];
+  }
+
+  // The state of an empty vector.
+  void reset() {
+    m_d = 0;
+    m_s = 1;
+    m_n = 0;
+    m_od = 1;
+    m_nd = 1;
+    m_os = 0;
+    m_ns = 1;
+    m_oseg = segmentCapacity();
+    m_tail = m_inline;
+  }
+
+  // Destroys all the elements, one data block at a time. Nothing is done for
+  // trivially destructible elements.
+  void destroy_all() {
+    if (std::is_trivially_destructible<T>::value) return;
+    for_each_span([](span<T> s) {
+      for (T& t : s) t.~T();
+    });
+  }
+
+  // Takes the elements of `other`, which is left empty. The elements in its
+  // inline blocks are moved one by one, and the other data blocks are taken
+  // over as they are.
+  void take(vector& other) {
+    m_directory = std::move(other.m_directory);
+    other.m_directory.clear();
+    m_blocks = other.m_blocks;
+    other.m_blocks = inlineBlocks();
+    m_ahead = other.m_ahead;
+    m_d = other.m_d;
+    m_s = other.m_s;
+    m_n = other.m_n;
+    m_od = other.m_od;
+    m_nd = other.m_nd;
+    m_os = other.m_os;
+    m_ns = other.m_ns;
+    m_oseg = other.m_oseg;
+    m_tail = m_d ? current_block() : m_inline;
+
+    const size_t capacity = inlineSegments() << N;
+    const size_t count = (size() < capacity) ? size() : capacity;
+    for (size_t i = 0; i < count; ++i) {
+      T& t = other.m_inline[i >> N][i & (segmentCapacity() - 1)];
+      new (&m_inline[i >> N][i & (segmentCapacity() - 1)]) T(std::move(t));
+      t.~T();
+    }
+    other.reset();
+  }
 
   void grow() {
     if (m_od == m_nd) {
@@ -54,13 +277,12 @@ class vector {
           m_nd <<= 1;
         m_os = 0;
       }
-      if (!m_emptyDb) {
-        m_data.emplace_back(new segment_t[m_nd]);
-      }
-      m_emptyDb = 0;
+      if (blocks() == m_d) push_block();
       ++m_d;
       ++m_os;
       m_od = 0;
+      m_tail = current_block();
+      if (m_ahead && blocks() == m_d) push_block();
     }
     ++m_n;
     ++m_od;
@@ -70,8 +292,8 @@ class vector {
     --m_n;
     --m_od;
     if (m_od == 0) {
-      if (m_emptyDb) m_data.pop_back();
       --m_d;
+      trim();
       --m_os;
       if (m_os == 0) {
         --m_s;
@@ -82,65 +304,225 @@ class vector {
         m_os = m_ns;
       }
       m_od = m_nd;
-      m_emptyDb = true;
-    }
-    if (m_n == 0) {
-      m_od = 1;
-      m_os = 0;
-      m_nd = 1;
-      m_ns = 1;
-      m_s = 1;
-      m_d = 0;
-      m_oseg = segmentCapacity();
-      m_emptyDb = true;
+      if (m_d) m_tail = current_block();
     }
+    if (m_n == 0) reset();
   };
 
+  // Releases the empty data blocks the retention policy does not keep. The
+  // inline blocks are always kept.
+  void trim() {
+    while (blocks() > inlineBlocks() &&
+           m_retention.release(blocks(), m_d,
+                               superblock::segments_in(blocks()), m_n))
+      pop_block();
+  }
+
   template <typename Vector>
   static auto& unsafe_at(Vector& v, size_t p) {
-    size_t elm = p & (v.segmentCapacity() - 1);
-    size_t pos = p >> N;
-
-    if (pos == 0) return v.m_data[0][0][elm];
-    if (pos == 1) return v.m_data[1][0][elm];
-    if (pos == 2) return v.m_data[1][1][elm];
+    const superblock::location loc = superblock::locate(p >> N);
+    return block_data(v, loc)[loc.segment][p & (segmentCapacity() - 1)];
+  };
 
-    pos += 1;
-    // the number of the superblock
-    uint64_t k;
-    __asm__("\tbsr %1, %0\n" : "=r"(k) : "r"(pos));
+  // The data block holding the element with index `p`, paired with the index
+  // of the first element in that block.
+  template <typename Vector>
+  static auto block_at(Vector& v, size_t p) {
+    const superblock::location loc = superblock::locate(p >> N);
+    const size_t offset = (loc.segment << N) + (p & (segmentCapacity() - 1));
+    return std::make_pair(
+        p - offset,
+        span<value_t<Vector>>{&block_data(v, loc)[0][0], loc.length << N});
+  }
 
-    const uint64_t kdiv2 = k >> 1;
-    const uint64_t oneShlKdiv2 = (1 << kdiv2);
-    const uint64_t notKdiv2 = oneShlKdiv2 - 1;
+  // The contiguous elements with indices in [p, last), up to the end of the
+  // data block holding the element with index `p`.
+  template <typename Vector>
+  static auto run_at(Vector& v, size_t p, size_t last) {
+    const auto block = block_at(v, p);
+    const size_t offset = p - block.first;
+    const size_t size = block.second.size - offset;
+    return span<value_t<Vector>>{block.second.data + offset,
+                                 (last - p < size) ? (last - p) : size};
+  }
 
-    // the first floor(k/2) bits after the most significant bit in k
-    const uint64_t mask_b = (notKdiv2 << kdiv2) << (k & 1);
+  // Appends `n` elements one contiguous run at a time. `fill(dst, count)` has
+  // to construct `count` objects at `dst`, and must not leave any of them
+  // behind if it throws.
+  template <typename Fill>
+  void extend(size_t n, Fill&& fill) {
+    reserve(size() + n);
+    while (n) {
+      if (m_oseg == segmentCapacity()) {
+        grow();
+        m_oseg = 0;
+      }
+      const size_t room =
+          ((size_t{m_nd} - m_od) << N) + segmentCapacity() - m_oseg;
+      const size_t count = (n < room) ? n : room;
+      try {
+        fill(&m_tail[m_od - 1][m_oseg], count);
+      } catch (...) {
+        if (m_oseg == 0) {
+          shrink();
+          m_oseg = segmentCapacity();
+        }
+        throw;
+      }
+      // the last of the filled elements, counting from the current segment
+      const size_t filled = m_oseg + count - 1;
+      m_n += filled >> N;
+      m_od += filled >> N;
+      m_oseg = (filled & (segmentCapacity() - 1)) + 1;
+      n -= count;
+    }
+  }
 
-    // the least significant ceil(k/2) bits in k
-    const uint64_t mask_seg = (oneShlKdiv2 << (k & 1)) - 1;
+  template <typename It>
+  static It copy_run(It first, T* dst, size_t count) {
+    It last = std::next(first, count);
+    std::uninitialized_copy(first, last, dst);
+    return last;
+  }
 
-    // the index of the data block in the k-th superblock
-    const uint64_t b = ((pos & mask_b) >> kdiv2) >> (k & 1);
+  template <typename U,
+            typename = std::enable_if_t<
+                std::is_trivially_copyable<T>::value &&
+                std::is_same<std::remove_const_t<U>, T>::value>>
+  static U* copy_run(U* first, T* dst, size_t count) {
+    std::memcpy(dst, first, count * sizeof(T));
+    return first + count;
+  }
 
-    // the index of the data segment in the b-th data block
-    const uint64_t seg = pos & mask_seg;
+  template <typename It>
+  void append(It first, It last, std::input_iterator_tag) {
+    for (; first != last; ++first) push(*first);
+  }
 
-    return v.m_data[(notKdiv2 << 1) + (k & 1) * oneShlKdiv2 + b][seg][elm];
-  };
+  template <typename It>
+  void append(It first, It last, std::forward_iterator_tag) {
+    extend(std::distance(first, last), [&first](T* dst, size_t count) {
+      first = copy_run(first, dst, count);
+    });
+  }
 
  public:
-  vector()
-      : m_d{0},
-        m_s{1},
-        m_n{0},
-        m_oseg{segmentCapacity()},
-        m_od{1},
-        m_os{0},
-        m_nd{1},
-        m_ns{1},
-        m_emptyDb{true} {
-    m_data.emplace_back(new segment_t[m_nd]);
+  using value_type = T;
+
+  vector() : vector{new_delete_resource()} {}
+
+  // Creates a vector whose data blocks are allocated from `resource`, which
+  // has to outlive it. Nothing is allocated until the vector outgrows its
+  // inline blocks.
+  explicit vector(memory_resource* resource) : m_resource{resource} {
+    reset();
+  }
+
+  vector(vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+      : m_resource{other.m_resource}, m_retention{other.m_retention} {
+    reset();
+    take(other);
+  }
+
+  ~vector() {
+    destroy_all();
+    while (blocks() > inlineBlocks()) pop_block();
+  }
+
+  vector& operator=(vector&& other) {
+    if (this != &other) {
+      destroy_all();
+      while (blocks() > inlineBlocks()) pop_block();
+      m_resource = other.m_resource;
+      m_retention = other.m_retention;
+      take(other);
+    }
+    return *this;
+  }
+
+  memory_resource* resource() const { return m_resource; }
+
+  // Sets how many empty data blocks are kept when the vector shrinks. By
+  // default one spare block is kept, so pushing and popping around a block
+  // boundary does not allocate every time.
+  vector& retain(retention policy) {
+    m_retention = policy;
+    trim();
+    return *this;
+  }
+
+  retention retention_policy() const { return m_retention; }
+
+  // Makes every push that starts a data block also allocate the block after
+  // it, so that the push filling the block does not wait for an allocation.
+  // Together with reserve(), this bounds the cost of every push.
+  vector& allocate_ahead(bool enable = true) {
+    m_ahead = enable;
+    if (m_ahead && m_d && blocks() == m_d) push_block();
+    return *this;
+  }
+
+  bool allocates_ahead() const { return m_ahead; }
+
+  // The memory held by the vector.
+  vector_stats stats() const {
+    const size_t block_bytes =
+        superblock::segments_in(blocks()) * sizeof(segment_t);
+    size_t directory_bytes =
+        m_directory.capacity() * sizeof(std::unique_ptr<segment_t*[]>);
+    for (size_t k = inlineSuperblocks(); k < m_directory.size(); ++k)
+      directory_bytes += superblock::blocks(k) * sizeof(segment_t*);
+    return {size(),
+            size() * sizeof(T),
+            block_bytes + directory_bytes,
+            block_bytes - size() * sizeof(T),
+            blocks(),
+            blocks() - m_d,
+            m_n ? superblock::locate(m_n - 1).superblock : 0,
+            directory_bytes,
+            sizeof(m_inline),
+            inlineBlocks()};
+  }
+
+  // Destroys all the elements. The data blocks that are then empty are kept
+  // or released according to the retention policy, as if the elements had
+  // been popped, but without walking the superblocks one by one.
+  vector& clear() {
+    destroy_all();
+    reset();
+    trim();
+    return *this;
+  }
+
+  // Destroys the elements from index `n` on. The counters step back a
+  // segment at a time rather than an element at a time.
+  vector& truncate(size_t n) {
+    if (n >= size()) return *this;
+    if (!std::is_trivially_destructible<T>::value)
+      for_each_span(n, size(), [](span<T> s) {
+        for (T& t : s) t.~T();
+      });
+    for (size_t drop = size() - n; drop;) {
+      if (drop < m_oseg) {
+        m_oseg -= drop;
+        break;
+      }
+      drop -= m_oseg;
+      shrink();
+      m_oseg = segmentCapacity();
+    }
+    return *this;
+  }
+
+  // Releases all the empty data blocks and the unused capacity of the block
+  // directory.
+  vector& shrink_to_fit() {
+    while (blocks() > inlineBlocks() && blocks() > m_d) pop_block();
+    if (blocks() == inlineBlocks()) {
+      m_directory.clear();
+      m_directory.shrink_to_fit();
+    }
+    return *this;
   }
 
   template <typename... Args>
@@ -151,12 +533,71 @@ class vector {
       grow();
       m_oseg = 1;
     }
-    m_data[m_d - 1][m_od - 1]
+    m_tail[m_od - 1]
         .overwrite(m_oseg - 1)
         .emplace(std::forward<Args>(args)...);
     return *this;
   }
 
+  // Allocates the data blocks needed to hold `n` elements, so that pushing up
+  // to `n` elements does not allocate.
+  vector& reserve(size_t n) {
+    const size_t segments = (n + segmentCapacity() - 1) >> N;
+    size_t count = blocks();
+    for (size_t s = superblock::segments_in(count); s < segments; ++count)
+      s += superblock::block_length(count);
+    while (blocks() < count) push_block();
+    return *this;
+  }
+
+  // The number of elements the allocated data blocks can hold.
+  size_t capacity() const {
+    return superblock::segments_in(blocks()) << N;
+  }
+
+  // Appends copies of the elements in [first, last). Whole runs of segments
+  // are filled at once, with memcpy for trivially copyable elements.
+  template <typename It>
+  vector& append(It first, It last) {
+    append(first, last,
+           typename std::iterator_traits<It>::iterator_category{});
+    return *this;
+  }
+
+  // Appends `n` copies of `value`.
+  vector& append_n(size_t n, T const& value) {
+    extend(n, [&value](T* dst, size_t count) {
+      std::uninitialized_fill_n(dst, count, value);
+    });
+    return *this;
+  }
+
+  // Appends `n` elements, each constructed in place from the result of
+  // calling `gen()`.
+  template <typename Generator>
+  vector& emplace_back_n(size_t n, Generator&& gen) {
+    extend(n, [&gen](T* dst, size_t count) {
+      size_t i{0};
+      try {
+        for (; i < count; ++i) new (dst + i) T(gen());
+      } catch (...) {
+        while (i) dst[--i].~T();
+        throw;
+      }
+    });
+    return *this;
+  }
+
+  // Appends `n` elements one contiguous run at a time, calling `fill(dst,
+  // count)` to construct `count` objects at `dst` for every run. The data
+  // blocks are all allocated before the first call. `fill` must not leave
+  // any of its objects behind if it throws.
+  template <typename Fill>
+  vector& append_runs(size_t n, Fill&& fill) {
+    extend(n, std::forward<Fill>(fill));
+    return *this;
+  }
+
   template <typename Vector>
   static auto at(Vector&& v, size_t p) {
     return xtd::opt(p < v.size(),
@@ -171,8 +612,10 @@ class vector {
 
   template <typename Vector>
   static auto back(Vector& v) {
-    return xtd::opt(v.m_od,
-                    std::ref(v.m_data[v.m_d - 1][v.m_od - 1][v.m_oseg - 1]));
+    using result_t = optional<std::reference_wrapper<value_t<Vector>>>;
+    if (v.empty()) return result_t{none{}};
+    return result_t{
+        std::ref<value_t<Vector>>(v.m_tail[v.m_od - 1][v.m_oseg - 1])};
   }
 
   auto back() { return back(*this); }
@@ -181,7 +624,9 @@ class vector {
 
   bool empty() const { return m_n == 0; }
 
-  size_t size() const { return (m_n) ? (((m_n - 1) << N) + m_oseg) : (0); }
+  size_t size() const {
+    return (m_n) ? (((size_t{m_n} - 1) << N) + m_oseg) : (0);
+  }
 
   optional<T> pop() {
     auto ret = back().map([](T& t) -> T {
@@ -190,7 +635,7 @@ class vector {
       return tc;
     });
 
-    if (!--m_oseg) {
+    if (!empty() && !--m_oseg) {
       shrink();
       m_oseg = segmentCapacity();
     }
@@ -198,28 +643,39 @@ class vector {
     return ret;
   }
 
-  constexpr T getDefaultValue() { return {}; }
-  constexpr T const getDefaultValue() const { return {}; }
-
   template <typename Container>
-  class iterator_t
-      : public std::iterator<std::random_access_iterator_tag,
-                             decltype(Container().getDefaultValue())> {
-    using super_t = std::iterator<std::random_access_iterator_tag,
-                                  decltype(Container().getDefaultValue())>;
+  class iterator_t : public std::iterator<std::random_access_iterator_tag,
+                                          value_t<Container>> {
+    using super_t =
+        std::iterator<std::random_access_iterator_tag, value_t<Container>>;
     using iter_mut = vector::template iterator_t<vector>;
     friend class vector::template iterator_t<vector const>;
 
     size_t i{0};
     Container* v{0};
 
+    // The data block holding the elements with indices in [lo, hi). Its
+    // segments are contiguous, so the iterator only decodes an index when it
+    // leaves the block.
+    mutable typename super_t::pointer run{nullptr};
+    mutable size_t lo{0};
+    mutable size_t hi{0};
+
+    void seek() const {
+      const auto block = block_at(*v, i);
+      run = block.second.data;
+      lo = block.first;
+      hi = lo + block.second.size;
+    }
+
    public:
     iterator_t() = default;
-    iterator_t(Container& v, size_t i) : v{&v}, i{i} {}
+    iterator_t(Container& v, size_t i) : i{i}, v{&v} {}
 
     // Any iterator (over either const or mutable) can be instantiated from an
     // iterator over mutables.
-    iterator_t(iter_mut const& other) : v{other.v}, i{other.i} {}
+    iterator_t(iter_mut const& other)
+        : i{other.i}, v{other.v}, run{other.run}, lo{other.lo}, hi{other.hi} {}
 
     // EqualityComparable
     bool operator==(iterator_t const& it) const {
@@ -232,12 +688,13 @@ class vector {
       i++;
       return *this;
     }
-    typename super_t::reference operator*() const { return unsafe_at(*v, i); }
-
-    typename super_t::reference operator->() const {
-      return Container::unsafe_at(*v, i);
+    typename super_t::reference operator*() const {
+      if (i - lo >= hi - lo) seek();
+      return run[i - lo];
     }
 
+    typename super_t::pointer operator->() const { return &**this; }
+
     auto operator++(int) {
       iterator_t it{*this};
       ++(*this);
@@ -282,8 +739,9 @@ class vector {
       return i - it.i;
     }
 
-    auto& operator[](typename super_t::difference_type n) const {
-      return v->at(i + n);
+    typename super_t::reference operator[](
+        typename super_t::difference_type n) const {
+      return *(*this + n);
     }
 
     bool operator<(iterator_t it) const { return (*this) - it < 0; }
@@ -297,6 +755,91 @@ class vector {
     // output iterator
   };
 
+  template <typename Container>
+  class span_iterator_t
+      : public std::iterator<std::forward_iterator_tag,
+                             span<value_t<Container>> const> {
+    Container* v{0};
+    size_t i{0};
+    size_t last{0};
+    span<value_t<Container>> s{nullptr, 0};
+
+    void load() {
+      if (i < last) s = run_at(*v, i, last);
+    }
+
+   public:
+    span_iterator_t() = default;
+    span_iterator_t(Container& v, size_t first, size_t last)
+        : v{&v}, i{first}, last{last} {
+      load();
+    }
+
+    bool operator==(span_iterator_t const& it) const {
+      return (i == it.i) && (v == it.v);
+    }
+    bool operator!=(span_iterator_t const& it) const { return !(*this == it); }
+
+    auto& operator++() {
+      i += s.size;
+      load();
+      return *this;
+    }
+    auto operator++(int) {
+      span_iterator_t it{*this};
+      ++(*this);
+      return it;
+    }
+
+    auto const& operator*() const { return s; }
+    auto const* operator->() const { return &s; }
+  };
+
+  template <typename Container>
+  class span_range_t {
+    span_iterator_t<Container> b;
+    span_iterator_t<Container> e;
+
+   public:
+    span_range_t(Container& v, size_t first, size_t last)
+        : b{v, first, last}, e{v, last, last} {}
+
+    auto begin() const { return b; }
+    auto end() const { return e; }
+  };
+
+  // The contiguous runs of elements with indices in [first, last). Each run
+  // spans as much of a data block as the range covers, so consecutive
+  // segments of the same block are yielded as a single span.
+  auto segments(size_t first, size_t last) {
+    last = (last < size()) ? last : size();
+    return span_range_t<vector>{*this, (first < last) ? first : last, last};
+  }
+  auto segments(size_t first, size_t last) const {
+    last = (last < size()) ? last : size();
+    return span_range_t<vector const>{*this, (first < last) ? first : last,
+                                      last};
+  }
+  auto segments() { return segments(0, size()); }
+  auto segments() const { return segments(0, size()); }
+
+  template <typename Fn>
+  void for_each_span(size_t first, size_t last, Fn&& fn) {
+    for (auto const& s : segments(first, last)) fn(s);
+  }
+  template <typename Fn>
+  void for_each_span(size_t first, size_t last, Fn&& fn) const {
+    for (auto const& s : segments(first, last)) fn(s);
+  }
+  template <typename Fn>
+  void for_each_span(Fn&& fn) {
+    for_each_span(0, size(), std::forward<Fn>(fn));
+  }
+  template <typename Fn>
+  void for_each_span(Fn&& fn) const {
+    for_each_span(0, size(), std::forward<Fn>(fn));
+  }
+
   using iterator = iterator_t<vector>;
   using const_iterator = iterator_t<vector const>;
 
@@ -309,6 +852,11 @@ class vector {
   const_iterator cbegin() const { return {*this, 0}; }
   const_iterator cend() const { return {*this, size()}; }
 };
+
+// An xtd::vector with 32-bit counters, for when many vectors are kept and
+// none of them goes past 2^32 - 1 segments.
+template <typename T, uint8_t N = 0>
+using compact_vector = vector<T, N, uint32_t>;
 }
 
 template <typename T>
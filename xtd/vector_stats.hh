@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace xtd {
+
+// The memory held by one vector.
+struct vector_stats {
+  size_t size;             // the number of elements
+  size_t bytes_in_use;     // the bytes of the elements
+  size_t bytes_allocated;  // the bytes of the data blocks and the directory,
+                           // including the inline blocks
+  size_t slack_bytes;      // the bytes of the data blocks not in use
+  size_t data_blocks;      // the number of data blocks, with the inline ones
+  size_t spare_blocks;     // the number of allocated, empty data blocks
+  size_t superblock;       // the index of the last superblock in use
+  size_t directory_bytes;  // the bytes of the data block directory
+  size_t inline_bytes;     // the bytes of the data blocks inside the vector
+  size_t inline_blocks;    // the number of data blocks inside the vector
+};
+
+// The data blocks held by all the vectors in the process. The counters are
+// only kept when XTD_VECTOR_STATS is defined, which has to be done the same
+// way for the whole program, and are zero otherwise.
+struct global_vector_stats {
+  size_t data_blocks;       // the number of allocated data blocks
+  size_t data_block_bytes;  // the bytes of the allocated data blocks
+  size_t allocations;       // the number of data blocks ever allocated
+};
+
+namespace detail {
+
+struct global_vector_counters {
+  std::atomic<size_t> data_blocks{0};
+  std::atomic<size_t> data_block_bytes{0};
+  std::atomic<size_t> allocations{0};
+};
+
+inline global_vector_counters& global_vector_counters_instance() {
+  static global_vector_counters counters;
+  return counters;
+}
+
+inline void count_block_allocation(size_t bytes) {
+#ifdef XTD_VECTOR_STATS
+  auto& counters = global_vector_counters_instance();
+  counters.data_blocks.fetch_add(1, std::memory_order_relaxed);
+  counters.data_block_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+#else
+  (void)bytes;
+#endif
+}
+
+inline void count_block_deallocation(size_t bytes) {
+#ifdef XTD_VECTOR_STATS
+  auto& counters = global_vector_counters_instance();
+  counters.data_blocks.fetch_sub(1, std::memory_order_relaxed);
+  counters.data_block_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+#else
+  (void)bytes;
+#endif
+}
+}
+
+// A snapshot of the process-wide counters, e.g. for a metrics exporter.
+inline global_vector_stats global_stats() {
+  auto const& counters = detail::global_vector_counters_instance();
+  return {counters.data_blocks.load(std::memory_order_relaxed),
+          counters.data_block_bytes.load(std::memory_order_relaxed),
+          counters.allocations.load(std::memory_order_relaxed)};
+}
+}